@@ -0,0 +1,73 @@
+#include "AdaptiveQuality.h"
+#include "Logger.h"
+#include <algorithm>
+
+namespace {
+    // Lowest to highest; the last level is the game's original fixed settings
+    const QualitySettings LEVELS[AdaptiveQuality::LEVEL_COUNT] = {
+        { "Low",    0.35f, 300,  4, 0.5f,  0.25f, 3 },
+        { "Medium", 0.6f,  500,  6, 0.7f,  0.1f,  4 },
+        { "High",   0.8f,  750,  8, 0.85f, 0.05f, 5 },
+        { "Full",   1.0f,  1000, 10, 1.0f, 0.0f,  5 }
+    };
+}
+
+const float AdaptiveQuality::UPGRADE_HEADROOM = 0.6f;
+
+AdaptiveQuality::AdaptiveQuality(float frameBudgetSeconds, int startLevel)
+    : frameBudget(frameBudgetSeconds)
+    , level(std::max(0, std::min(LEVEL_COUNT - 1, startLevel)))
+    , windowsUnderBudget(0) {
+    samples.reserve(WINDOW_FRAMES);
+    sortScratch.reserve(WINDOW_FRAMES);
+    stats.level = level.load(std::memory_order_relaxed);
+}
+
+const QualitySettings& AdaptiveQuality::getSettings(int level) {
+    return LEVELS[std::max(0, std::min(LEVEL_COUNT - 1, level))];
+}
+
+void AdaptiveQuality::addFrameTime(float seconds) {
+    samples.push_back(seconds);
+    if (samples.size() >= WINDOW_FRAMES) {
+        evaluateWindow();
+        samples.clear();
+    }
+}
+
+void AdaptiveQuality::evaluateWindow() {
+    sortScratch = samples;
+    const std::size_t medianIndex = sortScratch.size() / 2;
+    const std::size_t p95Index = sortScratch.size() * 95 / 100;
+    std::nth_element(sortScratch.begin(), sortScratch.begin() + p95Index, sortScratch.end());
+    const float p95 = sortScratch[p95Index];
+    std::nth_element(sortScratch.begin(), sortScratch.begin() + medianIndex, sortScratch.begin() + p95Index);
+    const float p50 = sortScratch[medianIndex];
+
+    stats.p50Milliseconds = p50 * 1000.0f;
+    stats.p95Milliseconds = p95 * 1000.0f;
+
+    const int current = getLevel();
+    if (p95 > frameBudget) {
+        windowsUnderBudget = 0;
+        if (current > 0) {
+            setLevel(current - 1);
+            ++stats.downgrades;
+        }
+    } else if (p95 < frameBudget * UPGRADE_HEADROOM) {
+        if (++windowsUnderBudget >= UPGRADE_WINDOWS && current < LEVEL_COUNT - 1) {
+            windowsUnderBudget = 0;
+            setLevel(current + 1);
+            ++stats.upgrades;
+        }
+    } else {
+        windowsUnderBudget = 0;
+    }
+}
+
+void AdaptiveQuality::setLevel(int newLevel) {
+    LOG_INFO("Quality", "Frame time p95 %.2f ms (budget %.2f ms): quality %s -> %s",
+             stats.p95Milliseconds, frameBudget * 1000.0f, getSettings(getLevel()).name, getSettings(newLevel).name);
+    level.store(newLevel, std::memory_order_relaxed);
+    stats.level = newLevel;
+}
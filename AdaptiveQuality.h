@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Everything the game is allowed to trade for frame time
+struct QualitySettings {
+    const char* name;
+    float particleScale;      // Multiplier on effect particle counts
+    int maxParticles;
+    int maxTrailPoints;       // Per projectile
+    float circleDetail;       // Multiplier on the pixel scale used to tessellate circles
+    float hudRefreshSeconds;  // Minimum time between HUD text rebuilds; 0 rebuilds every frame
+    int ghostTailSegments;
+};
+
+struct QualityStats {
+    int level = 0;
+    float p50Milliseconds = 0.0f; // Of the last complete window
+    float p95Milliseconds = 0.0f;
+    std::size_t downgrades = 0;
+    std::size_t upgrades = 0;
+};
+
+// Picks a quality level from measured frame times. Samples are collected in
+// windows of WINDOW_FRAMES; a window whose 95th percentile is over budget
+// drops one level at once, while going back up takes UPGRADE_WINDOWS windows
+// in a row under UPGRADE_HEADROOM of the budget. Between those two thresholds
+// the level is held, so it cannot flip back and forth around the budget.
+//
+// Frame times are fed by one thread; the level can be read from any thread.
+class AdaptiveQuality {
+public:
+    static const int LEVEL_COUNT = 4;
+
+    explicit AdaptiveQuality(float frameBudgetSeconds, int startLevel = LEVEL_COUNT - 1);
+
+    void addFrameTime(float seconds);
+
+    int getLevel() const { return level.load(std::memory_order_relaxed); }
+    const QualitySettings& getSettings() const { return getSettings(getLevel()); }
+    static const QualitySettings& getSettings(int level);
+
+    const QualityStats& getStats() const { return stats; }
+
+private:
+    float frameBudget;
+    std::atomic<int> level;
+    std::vector<float> samples;
+    std::vector<float> sortScratch;
+    int windowsUnderBudget;
+    QualityStats stats;
+
+    void evaluateWindow();
+    void setLevel(int newLevel);
+
+    static const std::size_t WINDOW_FRAMES = 120;
+    static const int UPGRADE_WINDOWS = 3;
+    static const float UPGRADE_HEADROOM;
+};
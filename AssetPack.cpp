@@ -0,0 +1,312 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace AssetPackFormat;
+
+std::uint64_t AssetPackFormat::hashName(const char* name, std::size_t length) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+AssetPack::AssetPack()
+    : base(nullptr)
+    , mappedSize(0)
+#ifdef _WIN32
+    , fileHandle(nullptr)
+    , mappingHandle(nullptr)
+#endif
+{
+}
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& packFilename) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(packFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    base = static_cast<const unsigned char*>(view);
+    mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(packFilename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<std::size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    base = static_cast<const unsigned char*>(view);
+    mappedSize = static_cast<std::size_t>(fileInfo.st_size);
+#endif
+
+    filename = packFilename;
+
+    if (!validate()) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void AssetPack::close() {
+    if (!base) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(const_cast<unsigned char*>(base), mappedSize);
+#endif
+
+    base = nullptr;
+    mappedSize = 0;
+    filename.clear();
+}
+
+bool AssetPack::find(const std::string& name, const void*& data, std::size_t& size) const {
+    const Entry* entry = findEntry(name.data(), name.size());
+    if (!entry) {
+        return false;
+    }
+
+    data = base + entry->offset;
+    size = static_cast<std::size_t>(entry->size);
+    return true;
+}
+
+bool AssetPack::contains(const std::string& name) const {
+    return findEntry(name.data(), name.size()) != nullptr;
+}
+
+std::size_t AssetPack::getEntryCount() const {
+    return base ? header()->entryCount : 0;
+}
+
+const Header* AssetPack::header() const {
+    return reinterpret_cast<const Header*>(base);
+}
+
+const Entry* AssetPack::findEntry(const char* name, std::size_t length) const {
+    if (!base) {
+        return nullptr;
+    }
+
+    const Header* head = header();
+    const Entry* table = reinterpret_cast<const Entry*>(base + head->tableOffset);
+    const char* names = reinterpret_cast<const char*>(base + head->namesOffset);
+    const std::uint32_t mask = head->tableSize - 1;
+    const std::uint64_t hash = hashName(name, length);
+
+    for (std::uint32_t probe = 0; probe < head->tableSize; ++probe) {
+        const Entry& entry = table[(hash + probe) & mask];
+        if (entry.offset == 0) {
+            return nullptr;
+        }
+        if (entry.hash == hash && entry.nameLength == length &&
+            std::memcmp(names + entry.nameOffset, name, length) == 0) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+bool AssetPack::validate() const {
+    const Header* head = header();
+
+    if (head->magic != MAGIC || head->version != VERSION) {
+        return false;
+    }
+    if (head->fileSize != mappedSize) {
+        return false;
+    }
+    if (head->tableSize == 0 || (head->tableSize & (head->tableSize - 1)) != 0) {
+        return false;
+    }
+    if (head->tableOffset % alignof(Entry) != 0 ||
+        head->tableOffset + static_cast<std::uint64_t>(head->tableSize) * sizeof(Entry) > head->namesOffset ||
+        head->namesOffset > head->dataOffset || head->dataOffset > mappedSize) {
+        return false;
+    }
+
+    const Entry* table = reinterpret_cast<const Entry*>(base + head->tableOffset);
+    for (std::uint32_t i = 0; i < head->tableSize; ++i) {
+        const Entry& entry = table[i];
+        if (entry.offset == 0) {
+            continue;
+        }
+        if (entry.offset < head->dataOffset || entry.offset + entry.size > mappedSize ||
+            head->namesOffset + entry.nameOffset + entry.nameLength > head->dataOffset) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool AssetPackWriter::addFile(const std::string& name, const std::string& sourceFilename) {
+    std::ifstream file(sourceFilename, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    addBlob(name, std::move(data));
+    return true;
+}
+
+void AssetPackWriter::addBlob(const std::string& name, std::vector<unsigned char> data) {
+    auto it = std::find_if(entries.begin(), entries.end(),
+        [&name](const PendingEntry& entry) { return entry.name == name; });
+
+    if (it != entries.end()) {
+        it->data = std::move(data);
+    } else {
+        entries.push_back({name, std::move(data)});
+    }
+}
+
+bool AssetPackWriter::write(const std::string& outputFilename) const {
+    auto alignUp = [](std::uint64_t value) {
+        return (value + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+    };
+
+    // Keep the table at most half full so probe chains stay short
+    std::uint32_t tableSize = 1;
+    while (tableSize < entries.size() * 2) {
+        tableSize <<= 1;
+    }
+
+    Header head = {};
+    head.magic = MAGIC;
+    head.version = VERSION;
+    head.tableSize = tableSize;
+    head.entryCount = static_cast<std::uint32_t>(entries.size());
+    head.tableOffset = sizeof(Header);
+    head.namesOffset = head.tableOffset + static_cast<std::uint64_t>(tableSize) * sizeof(Entry);
+
+    std::string names;
+    std::vector<Entry> table(tableSize);
+    std::vector<std::uint64_t> blobOffsets(entries.size());
+
+    for (const auto& pending : entries) {
+        names += pending.name;
+    }
+    head.dataOffset = alignUp(head.namesOffset + names.size());
+
+    std::uint64_t cursor = head.dataOffset;
+    std::uint32_t nameCursor = 0;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const PendingEntry& pending = entries[i];
+        blobOffsets[i] = cursor;
+
+        Entry entry = {};
+        entry.hash = hashName(pending.name.data(), pending.name.size());
+        entry.offset = cursor;
+        entry.size = pending.data.size();
+        entry.nameOffset = nameCursor;
+        entry.nameLength = static_cast<std::uint32_t>(pending.name.size());
+
+        std::uint32_t slot = static_cast<std::uint32_t>(entry.hash) & (tableSize - 1);
+        while (table[slot].offset != 0) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        table[slot] = entry;
+
+        nameCursor += entry.nameLength;
+        // Empty blobs still get a distinct, non-zero offset
+        cursor = alignUp(cursor + std::max<std::uint64_t>(pending.data.size(), 1));
+    }
+    head.fileSize = cursor;
+
+    std::ofstream file(outputFilename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    auto padTo = [&file](std::uint64_t offset) {
+        static const char zeros[BLOB_ALIGNMENT] = {};
+        std::uint64_t position = static_cast<std::uint64_t>(file.tellp());
+        while (position < offset) {
+            std::uint64_t chunk = std::min<std::uint64_t>(offset - position, BLOB_ALIGNMENT);
+            file.write(zeros, static_cast<std::streamsize>(chunk));
+            position += chunk;
+        }
+    };
+
+    file.write(reinterpret_cast<const char*>(&head), sizeof(head));
+    file.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(Entry)));
+    file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        padTo(blobOffsets[i]);
+        const auto& data = entries[i].data;
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+    padTo(head.fileSize);
+
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Packed asset archive (.pak)
+//
+// File layout:
+//   Header
+//   Entry[tableSize]      open-addressed hash table, probed linearly
+//   name bytes            entry names, not null-terminated
+//   blobs                 each blob starts on a BLOB_ALIGNMENT boundary
+//
+// Entry names are asset paths relative to the assets directory using '/'
+// separators, e.g. "textures/superman.png".
+namespace AssetPackFormat {
+    const std::uint32_t MAGIC = 0x4B505653; // "SVPK"
+    const std::uint32_t VERSION = 1;
+    const std::uint64_t BLOB_ALIGNMENT = 64;
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t tableSize;   // Power of two
+        std::uint32_t entryCount;
+        std::uint64_t tableOffset;
+        std::uint64_t namesOffset;
+        std::uint64_t dataOffset;
+        std::uint64_t fileSize;
+    };
+
+    struct Entry {
+        std::uint64_t hash;
+        std::uint64_t offset;      // 0 marks an empty slot
+        std::uint64_t size;
+        std::uint32_t nameOffset;  // Relative to namesOffset
+        std::uint32_t nameLength;
+    };
+
+    static_assert(sizeof(Header) == 48, "AssetPack header layout changed");
+    static_assert(sizeof(Entry) == 32, "AssetPack entry layout changed");
+
+    // FNV-1a, 64 bit
+    std::uint64_t hashName(const char* name, std::size_t length);
+}
+
+// Read-only view of a memory-mapped asset pack. Blobs returned by find()
+// point straight into the mapping and stay valid until close().
+class AssetPack {
+public:
+    AssetPack();
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    bool find(const std::string& name, const void*& data, std::size_t& size) const;
+    bool contains(const std::string& name) const;
+
+    std::size_t getEntryCount() const;
+    std::size_t getMappedSize() const { return mappedSize; }
+    const std::string& getFilename() const { return filename; }
+
+private:
+    const unsigned char* base;
+    std::size_t mappedSize;
+    std::string filename;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    const AssetPackFormat::Header* header() const;
+    const AssetPackFormat::Entry* findEntry(const char* name, std::size_t length) const;
+    bool validate() const;
+};
+
+// Builds a pack file from loose assets. Used by the asset_packer tool.
+class AssetPackWriter {
+public:
+    bool addFile(const std::string& name, const std::string& filename);
+    void addBlob(const std::string& name, std::vector<unsigned char> data);
+    bool write(const std::string& filename) const;
+
+    std::size_t getEntryCount() const { return entries.size(); }
+
+private:
+    struct PendingEntry {
+        std::string name;
+        std::vector<unsigned char> data;
+    };
+
+    std::vector<PendingEntry> entries;
+};
@@ -0,0 +1,213 @@
+#include "AudioThread.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+namespace {
+    const std::uint64_t REPORT_INTERVAL_NS = 30ull * 1000000000ull;
+}
+
+AudioThread::AudioThread()
+    : voicePool(nullptr)
+    , music(nullptr)
+    , batchPending(false)
+    , sleeping(false)
+    , latencySamples(0)
+    , latencyTotalNs(0)
+    , latencyMaxNs(0)
+    , droppedCommands(0)
+    , lastReport(0) {
+    for (auto& bucket : latencyHistogram) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+AudioThread::~AudioThread() {
+    stop();
+}
+
+std::uint64_t AudioThread::now() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void AudioThread::start(AudioVoicePool& voices, sf::Music& backgroundMusic) {
+    if (worker.joinable()) {
+        return;
+    }
+    voicePool = &voices;
+    music = &backgroundMusic;
+    lastReport = now();
+    worker = std::thread(&AudioThread::run, this);
+}
+
+void AudioThread::stop() {
+    if (!worker.joinable()) {
+        return;
+    }
+
+    // Shutdown must get through even if the queue is momentarily full
+    const AudioCommand shutdown = { AudioCommandType::Shutdown, SoundEvent::Count, now() };
+    while (!commands.push(shutdown)) {
+        std::this_thread::yield();
+    }
+    wakeWorker();
+    worker.join();
+    logLatencyStats();
+}
+
+void AudioThread::playEffect(SoundEvent event) { post(AudioCommandType::PlayEffect, event); }
+void AudioThread::endFrame() { post(AudioCommandType::EndFrame); }
+void AudioThread::stopEffects() { post(AudioCommandType::StopEffects); }
+void AudioThread::playMusic() { post(AudioCommandType::PlayMusic); }
+void AudioThread::pauseMusic() { post(AudioCommandType::PauseMusic); }
+void AudioThread::stopMusic() { post(AudioCommandType::StopMusic); }
+
+void AudioThread::post(AudioCommandType type, SoundEvent event) {
+    const AudioCommand command = { type, event, now() };
+
+    if (!worker.joinable()) {
+        // Not started (or already stopped): nothing else touches the audio objects
+        execute(command);
+        return;
+    }
+
+    if (!commands.push(command)) {
+        droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    wakeWorker();
+}
+
+void AudioThread::wakeWorker() {
+    // Pairs with the fence in run(): either the audio thread sees the command
+    // before it sleeps, or this sees it sleeping and wakes it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeCondition.notify_one();
+    }
+}
+
+void AudioThread::run() {
+    AudioCommand command;
+    for (;;) {
+        bool idle = true;
+        while (commands.pop(command)) {
+            idle = false;
+            if (!execute(command)) {
+                // Leave nothing playing behind the game's back
+                voicePool->stopAll();
+                music->stop();
+                return;
+            }
+        }
+
+        if (now() - lastReport >= REPORT_INTERVAL_NS) {
+            lastReport = now();
+            logLatencyStats();
+        }
+
+        if (idle) {
+            // Sleep until a command arrives; the timeout only serves the latency report
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::uint64_t current = now();
+            const std::uint64_t reportDue = lastReport + REPORT_INTERVAL_NS;
+            if (commands.empty() && reportDue > current) {
+                wakeCondition.wait_for(lock, std::chrono::nanoseconds(reportDue - current));
+            }
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AudioThread::execute(const AudioCommand& command) {
+    if (!voicePool || !music) {
+        return command.type != AudioCommandType::Shutdown;
+    }
+
+    switch (command.type) {
+        case AudioCommandType::PlayEffect:
+            voicePool->enqueue(command.event);
+            batchPending = true;
+            return true;
+        case AudioCommandType::EndFrame:
+            if (batchPending) {
+                voicePool->flush();
+                batchPending = false;
+                recordLatency(now() - command.enqueueTime);
+            }
+            return true;
+        case AudioCommandType::StopEffects:
+            voicePool->stopAll();
+            batchPending = false;
+            return true;
+        case AudioCommandType::PlayMusic:
+            music->play();
+            break;
+        case AudioCommandType::PauseMusic:
+            music->pause();
+            break;
+        case AudioCommandType::StopMusic:
+            music->stop();
+            break;
+        case AudioCommandType::Shutdown:
+            return false;
+    }
+
+    recordLatency(now() - command.enqueueTime);
+    return true;
+}
+
+void AudioThread::recordLatency(std::uint64_t nanoseconds) {
+    std::size_t bucket = 0;
+    std::uint64_t microseconds = nanoseconds / 1000;
+    while (microseconds > 0 && bucket + 1 < LATENCY_BUCKETS) {
+        microseconds >>= 1;
+        ++bucket;
+    }
+
+    latencyHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    latencySamples.fetch_add(1, std::memory_order_relaxed);
+    latencyTotalNs.fetch_add(nanoseconds, std::memory_order_relaxed);
+    if (nanoseconds > latencyMaxNs.load(std::memory_order_relaxed)) {
+        // Only the audio thread writes, so a plain store is enough
+        latencyMaxNs.store(nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+AudioLatencyStats AudioThread::getLatencyStats() const {
+    AudioLatencyStats stats;
+    stats.samples = latencySamples.load(std::memory_order_relaxed);
+    stats.droppedCommands = droppedCommands.load(std::memory_order_relaxed);
+    if (stats.samples == 0) {
+        return stats;
+    }
+
+    stats.averageMicroseconds = latencyTotalNs.load(std::memory_order_relaxed) / 1000.0 / stats.samples;
+    stats.maxMicroseconds = latencyMaxNs.load(std::memory_order_relaxed) / 1000.0;
+
+    const std::uint64_t target = stats.samples - stats.samples / 100;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+        seen += latencyHistogram[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            stats.p99Microseconds = std::min(static_cast<double>(1ull << i), stats.maxMicroseconds);
+            break;
+        }
+    }
+    return stats;
+}
+
+void AudioThread::logLatencyStats() const {
+    const AudioLatencyStats stats = getLatencyStats();
+    if (stats.samples == 0) {
+        return;
+    }
+    LOG_INFO("Audio", "Command latency: avg %.1f us, p99 < %.0f us, max %.1f us over %llu commands, %llu dropped",
+             stats.averageMicroseconds, stats.p99Microseconds, stats.maxMicroseconds,
+             stats.samples, stats.droppedCommands);
+}
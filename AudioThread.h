@@ -0,0 +1,98 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "AudioVoicePool.h"
+#include "SpscQueue.h"
+
+enum class AudioCommandType : std::uint8_t {
+    PlayEffect,
+    EndFrame,
+    StopEffects,
+    PlayMusic,
+    PauseMusic,
+    StopMusic,
+    Shutdown
+};
+
+struct AudioCommand {
+    AudioCommandType type;
+    SoundEvent event;
+    std::uint64_t enqueueTime; // Nanoseconds, AudioThread clock
+};
+
+struct AudioLatencyStats {
+    std::uint64_t samples = 0;
+    double averageMicroseconds = 0.0;
+    double p99Microseconds = 0.0;  // Upper edge of the histogram bucket
+    double maxMicroseconds = 0.0;
+    std::uint64_t droppedCommands = 0;
+};
+
+// Owns every OpenAL call. The game thread only pushes small POD commands into
+// a lock-free SPSC queue; the audio thread applies them to the voice pool and
+// the music stream. Effects posted between two endFrame() calls are played
+// as one batch, so the voice pool's per-frame deduplication still holds.
+//
+// Once start() has been called the pool and music passed to it belong to the
+// audio thread and must not be touched from anywhere else until stop().
+class AudioThread {
+public:
+    AudioThread();
+    ~AudioThread();
+
+    void start(AudioVoicePool& voices, sf::Music& music);
+    void stop();
+    bool isRunning() const { return worker.joinable(); }
+
+    // Game thread
+    void playEffect(SoundEvent event);
+    void endFrame();
+    void stopEffects();
+    void playMusic();
+    void pauseMusic();
+    void stopMusic();
+
+    // Latency from a command being pushed to its sounds being started (for
+    // effects, from the frame's endFrame()); safe to call from any thread
+    AudioLatencyStats getLatencyStats() const;
+    void logLatencyStats() const;
+
+private:
+    static const std::size_t QUEUE_CAPACITY = 256;
+    static const std::size_t LATENCY_BUCKETS = 32; // Bucket i counts latencies below 2^i microseconds
+
+    SpscQueue<AudioCommand, QUEUE_CAPACITY> commands;
+    std::thread worker;
+    AudioVoicePool* voicePool;
+    sf::Music* music;
+
+    // Effects are waiting for the next EndFrame
+    bool batchPending;
+
+    // The audio thread sleeps while the queue is empty; posting only takes the
+    // lock to wake it when it is asleep
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<bool> sleeping;
+
+    // Latency statistics, written by the audio thread
+    std::array<std::atomic<std::uint64_t>, LATENCY_BUCKETS> latencyHistogram;
+    std::atomic<std::uint64_t> latencySamples;
+    std::atomic<std::uint64_t> latencyTotalNs;
+    std::atomic<std::uint64_t> latencyMaxNs;
+    std::atomic<std::uint64_t> droppedCommands;
+    std::uint64_t lastReport;
+
+    static std::uint64_t now();
+    void post(AudioCommandType type, SoundEvent event = SoundEvent::Count);
+    void wakeWorker();
+    void run();
+    bool execute(const AudioCommand& command);
+    void recordLatency(std::uint64_t nanoseconds);
+};
@@ -0,0 +1,126 @@
+#include "AudioVoicePool.h"
+#include <algorithm>
+
+namespace {
+    // Higher plays first and may steal voices from lower
+    const int EVENT_PRIORITIES[] = {
+        1, // Laser
+        2, // Punch
+        3  // GhostDeath
+    };
+}
+
+AudioVoicePool::AudioVoicePool()
+    : nextSerial(1) {
+    buffers.fill(nullptr);
+    pending.fill(0);
+}
+
+int AudioVoicePool::getPriority(SoundEvent event) {
+    return event < SoundEvent::Count ? EVENT_PRIORITIES[static_cast<std::size_t>(event)] : 0;
+}
+
+void AudioVoicePool::setBuffer(SoundEvent event, const sf::SoundBuffer* buffer) {
+    if (event >= SoundEvent::Count) {
+        return;
+    }
+    buffers[static_cast<std::size_t>(event)] = buffer;
+
+    // Voices still holding the old buffer must not keep a dangling pointer
+    for (auto& voice : voices) {
+        if (voice.event == event) {
+            voice.sound.stop();
+            voice.sound.resetBuffer();
+            voice.event = SoundEvent::Count;
+        }
+    }
+}
+
+void AudioVoicePool::enqueue(SoundEvent event) {
+    if (event >= SoundEvent::Count) {
+        return;
+    }
+    std::uint32_t& count = pending[static_cast<std::size_t>(event)];
+    if (count > 0) {
+        ++stats.deduplicated;
+    }
+    ++count;
+}
+
+void AudioVoicePool::flush() {
+    // Most important first, so low priority events can't take the last free voices
+    std::array<SoundEvent, EVENT_COUNT> order;
+    for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+        order[i] = static_cast<SoundEvent>(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [](SoundEvent a, SoundEvent b) {
+        return getPriority(a) > getPriority(b);
+    });
+
+    for (SoundEvent event : order) {
+        if (pending[static_cast<std::size_t>(event)] > 0) {
+            play(event);
+            pending[static_cast<std::size_t>(event)] = 0;
+        }
+    }
+}
+
+void AudioVoicePool::stopAll() {
+    for (auto& voice : voices) {
+        voice.sound.stop();
+    }
+    pending.fill(0);
+}
+
+std::size_t AudioVoicePool::getActiveVoiceCount() const {
+    return static_cast<std::size_t>(std::count_if(voices.begin(), voices.end(), [](const Voice& voice) {
+        return voice.sound.getStatus() == sf::Sound::Playing;
+    }));
+}
+
+void AudioVoicePool::play(SoundEvent event) {
+    const sf::SoundBuffer* buffer = buffers[static_cast<std::size_t>(event)];
+    if (!buffer) {
+        ++stats.dropped;
+        return;
+    }
+
+    Voice* voice = findVoice(getPriority(event));
+    if (!voice) {
+        ++stats.dropped;
+        return;
+    }
+
+    if (voice->sound.getBuffer() != buffer) {
+        voice->sound.setBuffer(*buffer);
+    }
+    voice->event = event;
+    voice->startSerial = nextSerial++;
+    voice->sound.play();
+    ++stats.played;
+}
+
+AudioVoicePool::Voice* AudioVoicePool::findVoice(int priority) {
+    Voice* victim = nullptr;
+    for (auto& voice : voices) {
+        if (voice.sound.getStatus() != sf::Sound::Playing) {
+            return &voice;
+        }
+
+        // Steal the lowest priority voice, the oldest among equals
+        const int voicePriority = getPriority(voice.event);
+        if (voicePriority > priority) {
+            continue;
+        }
+        if (!victim || voicePriority < getPriority(victim->event) ||
+            (voicePriority == getPriority(victim->event) && voice.startSerial < victim->startSerial)) {
+            victim = &voice;
+        }
+    }
+
+    if (victim) {
+        victim->sound.stop();
+        ++stats.stolen;
+    }
+    return victim;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <array>
+#include <cstdint>
+
+enum class SoundEvent : std::uint8_t {
+    Laser,
+    Punch,
+    GhostDeath,
+    Count
+};
+
+struct AudioVoiceStats {
+    std::uint64_t played = 0;
+    std::uint64_t deduplicated = 0; // Identical events merged within one frame
+    std::uint64_t stolen = 0;       // Voices cut off for a more important event
+    std::uint64_t dropped = 0;      // Events with no voice to play on
+};
+
+// Fixed set of sf::Sound voices shared by every sound effect.
+//
+// Game code queues events during the frame and the pool plays them in one
+// batch: repeats of an event within a frame play once, higher priority events
+// are started first, and when every voice is busy the oldest voice of the
+// lowest priority no higher than the new event's is stolen.
+class AudioVoicePool {
+public:
+    static const std::size_t VOICE_COUNT = 16;
+
+    AudioVoicePool();
+
+    void setBuffer(SoundEvent event, const sf::SoundBuffer* buffer);
+
+    // Queues an event for the next flush
+    void enqueue(SoundEvent event);
+    // Starts everything queued this frame
+    void flush();
+    void stopAll();
+
+    const AudioVoiceStats& getStats() const { return stats; }
+    std::size_t getActiveVoiceCount() const;
+
+    static int getPriority(SoundEvent event);
+
+private:
+    static const std::size_t EVENT_COUNT = static_cast<std::size_t>(SoundEvent::Count);
+
+    struct Voice {
+        sf::Sound sound;
+        SoundEvent event = SoundEvent::Count;
+        std::uint64_t startSerial = 0;
+    };
+
+    std::array<Voice, VOICE_COUNT> voices;
+    std::array<const sf::SoundBuffer*, EVENT_COUNT> buffers;
+    std::array<std::uint32_t, EVENT_COUNT> pending;
+    std::uint64_t nextSerial;
+    AudioVoiceStats stats;
+
+    void play(SoundEvent event);
+    Voice* findVoice(int priority);
+};
@@ -0,0 +1,211 @@
+#include "BackgroundStreamer.h"
+#include "RenderQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    // Buildings stand on lots of fixed width along the bottom edge of the world
+    const int LOT_WIDTH = 48;
+    const int MIN_BUILDING_HEIGHT = 140;
+    const int MAX_BUILDING_HEIGHT = 460;
+    const int WINDOW_CELL_WIDTH = 12;
+    const int WINDOW_CELL_HEIGHT = 18;
+
+    std::uint32_t hashValues(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+        // splitmix64 finalizer over the packed inputs
+        std::uint64_t h = (static_cast<std::uint64_t>(a) << 32 | b) ^ (static_cast<std::uint64_t>(c) * 0x9E3779B97F4A7C15ull);
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<std::uint32_t>(h ^ (h >> 31));
+    }
+}
+
+const float BackgroundStreamer::LOAD_DISTANCE = 0.5f * BackgroundStreamer::CHUNK_SIZE;
+const float BackgroundStreamer::EVICT_DISTANCE = 1.5f * BackgroundStreamer::CHUNK_SIZE;
+
+BackgroundStreamer::BackgroundStreamer()
+    : worldSize(800.0f, 600.0f)
+    , seed(0x5EED) {
+}
+
+BackgroundStreamer::~BackgroundStreamer() {
+    // Workers only touch their own canvas, but wait so none outlive the streamer
+    for (auto& entry : pending) {
+        entry.second.wait();
+    }
+}
+
+void BackgroundStreamer::update(const sf::FloatRect& viewBounds) {
+    uploadFinishedChunks();
+    evictChunks(viewBounds);
+    requestChunks(viewBounds);
+
+    stats.resident = resident.size();
+    stats.peakResident = std::max(stats.peakResident, stats.resident);
+    stats.pending = pending.size();
+}
+
+void BackgroundStreamer::submit(RenderQueue& queue, const sf::FloatRect& viewBounds) const {
+    for (const auto& entry : resident) {
+        const Chunk& chunk = entry.second;
+        if (!getChunkBounds(chunk.x, chunk.y).intersects(viewBounds)) {
+            continue;
+        }
+        sf::Sprite sprite(*chunk.texture);
+        sprite.setPosition(static_cast<float>(chunk.x * static_cast<int>(CHUNK_SIZE)),
+                           static_cast<float>(chunk.y * static_cast<int>(CHUNK_SIZE)));
+        queue.submit(RenderLayer::Background, sprite);
+    }
+}
+
+void BackgroundStreamer::requestChunks(const sf::FloatRect& viewBounds) {
+    const float chunkSize = static_cast<float>(CHUNK_SIZE);
+    const int lastX = static_cast<int>(std::ceil(worldSize.x / chunkSize)) - 1;
+    const int lastY = static_cast<int>(std::ceil(worldSize.y / chunkSize)) - 1;
+
+    const int minX = std::max(0, static_cast<int>(std::floor((viewBounds.left - LOAD_DISTANCE) / chunkSize)));
+    // Rows above the tallest roof would be fully transparent, so they are never generated
+    const int firstCityRow = static_cast<int>(std::floor((worldSize.y - MAX_BUILDING_HEIGHT) / chunkSize));
+    const int minY = std::max(std::max(0, firstCityRow),
+                              static_cast<int>(std::floor((viewBounds.top - LOAD_DISTANCE) / chunkSize)));
+    const int maxX = std::min(lastX, static_cast<int>(std::floor((viewBounds.left + viewBounds.width + LOAD_DISTANCE) / chunkSize)));
+    const int maxY = std::min(lastY, static_cast<int>(std::floor((viewBounds.top + viewBounds.height + LOAD_DISTANCE) / chunkSize)));
+
+    // Nearest missing chunks first, so what is on screen arrives before the margin
+    const sf::Vector2f viewCenter(viewBounds.left + viewBounds.width * 0.5f, viewBounds.top + viewBounds.height * 0.5f);
+    std::vector<std::pair<float, std::uint32_t>> missing;
+    for (int y = minY; y <= maxY; ++y) {
+        for (int x = minX; x <= maxX; ++x) {
+            const std::uint32_t key = packChunkKey(x, y);
+            if (resident.count(key) || pending.count(key)) {
+                continue;
+            }
+            float dx = (x + 0.5f) * chunkSize - viewCenter.x;
+            float dy = (y + 0.5f) * chunkSize - viewCenter.y;
+            missing.push_back(std::make_pair(dx * dx + dy * dy, key));
+        }
+    }
+    std::sort(missing.begin(), missing.end());
+
+    for (const auto& request : missing) {
+        if (pending.size() >= MAX_PENDING) {
+            break;
+        }
+        const int x = static_cast<int>(request.second & 0xFFFF);
+        const int y = static_cast<int>(request.second >> 16);
+        pending[request.second] = std::async(std::launch::async, &BackgroundStreamer::generateChunk,
+                                             x, y, worldSize, seed);
+    }
+}
+
+void BackgroundStreamer::uploadFinishedChunks() {
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+
+        PixelCanvas canvas = it->second.get();
+
+        // Recycle an evicted chunk's texture instead of allocating a new one
+        std::unique_ptr<sf::Texture> texture;
+        if (!freeTextures.empty()) {
+            texture = std::move(freeTextures.back());
+            freeTextures.pop_back();
+        } else {
+            texture.reset(new sf::Texture());
+            texture->create(CHUNK_SIZE, CHUNK_SIZE);
+        }
+        texture->update(canvas.getPixelsPtr());
+
+        Chunk chunk;
+        chunk.x = static_cast<int>(it->first & 0xFFFF);
+        chunk.y = static_cast<int>(it->first >> 16);
+        chunk.texture = std::move(texture);
+        resident[it->first] = std::move(chunk);
+        ++stats.generated;
+
+        it = pending.erase(it);
+    }
+}
+
+void BackgroundStreamer::evictChunks(const sf::FloatRect& viewBounds) {
+    const sf::FloatRect keepBounds(viewBounds.left - EVICT_DISTANCE, viewBounds.top - EVICT_DISTANCE,
+                                   viewBounds.width + EVICT_DISTANCE * 2, viewBounds.height + EVICT_DISTANCE * 2);
+    for (auto it = resident.begin(); it != resident.end();) {
+        if (getChunkBounds(it->second.x, it->second.y).intersects(keepBounds)) {
+            ++it;
+            continue;
+        }
+        freeTextures.push_back(std::move(it->second.texture));
+        it = resident.erase(it);
+        ++stats.evicted;
+    }
+
+    // Keep a few spare textures around for chunks coming into view; release the rest
+    if (freeTextures.size() > MAX_PENDING) {
+        freeTextures.resize(MAX_PENDING);
+    }
+}
+
+sf::FloatRect BackgroundStreamer::getChunkBounds(int x, int y) const {
+    const float chunkSize = static_cast<float>(CHUNK_SIZE);
+    return sf::FloatRect(x * chunkSize, y * chunkSize, chunkSize, chunkSize);
+}
+
+std::uint32_t BackgroundStreamer::packChunkKey(int x, int y) {
+    return (static_cast<std::uint32_t>(y) << 16) | (static_cast<std::uint32_t>(x) & 0xFFFF);
+}
+
+PixelCanvas BackgroundStreamer::generateChunk(int chunkX, int chunkY, sf::Vector2f worldSize, std::uint32_t seed) {
+    const int size = static_cast<int>(CHUNK_SIZE);
+    const int originX = chunkX * size;
+    const int originY = chunkY * size;
+    const int ground = static_cast<int>(worldSize.y);
+
+    PixelCanvas canvas(CHUNK_SIZE, CHUNK_SIZE);
+
+    // Per column: roof height, or below the ground in the gaps between buildings
+    std::vector<int> buildingTop(CHUNK_SIZE);
+    for (int x = 0; x < size; ++x) {
+        const int worldX = originX + x;
+        const int lot = worldX / LOT_WIDTH;
+        const std::uint32_t lotHash = hashValues(seed, static_cast<std::uint32_t>(lot), 0);
+        const int height = MIN_BUILDING_HEIGHT + static_cast<int>(lotHash % (MAX_BUILDING_HEIGHT - MIN_BUILDING_HEIGHT));
+        const int gap = 2 + static_cast<int>((lotHash >> 16) % 8);
+        const int inLot = worldX - lot * LOT_WIDTH;
+        buildingTop[x] = (inLot >= gap && inLot < LOT_WIDTH - gap) ? ground - height : ground + 1;
+    }
+
+    const std::uint32_t buildingColor = PixelCanvas::pack(sf::Color(5, 5, 15));
+    const std::uint32_t litWindowColor = PixelCanvas::pack(sf::Color(255, 220, 120));
+
+    for (int y = 0; y < size; ++y) {
+        const int worldY = originY + y;
+        const int windowRow = (ground - worldY) / WINDOW_CELL_HEIGHT;
+        const bool windowBand = (ground - worldY) % WINDOW_CELL_HEIGHT >= 6;
+
+        std::uint32_t* row = canvas.row(static_cast<unsigned int>(y));
+        for (int x = 0; x < size; ++x) {
+            // Open sky stays transparent so the parallax layers show through
+            if (worldY < buildingTop[x] || worldY >= ground) {
+                row[x] = 0;
+                continue;
+            }
+
+            // Window grid anchored to the ground, each window lit at random
+            const int worldX = originX + x;
+            const int inCell = worldX % WINDOW_CELL_WIDTH;
+            const bool inWindow = windowBand && inCell >= 3 && inCell < 9 && worldY > buildingTop[x] + 8;
+            bool lit = false;
+            if (inWindow) {
+                lit = hashValues(seed, static_cast<std::uint32_t>(worldX / WINDOW_CELL_WIDTH),
+                                 static_cast<std::uint32_t>(windowRow) + 1) % 10 < 3;
+            }
+            row[x] = lit ? litWindowColor : buildingColor;
+        }
+    }
+
+    return canvas;
+}
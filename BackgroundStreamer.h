@@ -0,0 +1,77 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <vector>
+#include "PixelCanvas.h"
+
+class RenderQueue;
+
+struct BackgroundStreamStats {
+    std::size_t generated = 0;
+    std::size_t evicted = 0;
+    std::size_t resident = 0;
+    std::size_t peakResident = 0;
+    std::size_t pending = 0;
+};
+
+// Streams the near city skyline as fixed-size chunks around the camera. The
+// sky is left transparent for the parallax layers behind it, and chunk rows
+// above the tallest roof are skipped altogether. Chunk pixels are generated on
+// worker threads once the camera comes within LOAD_DISTANCE of them; the
+// texture upload happens on the render thread. Chunks further than EVICT_DISTANCE from the view are dropped and
+// their textures recycled, so memory stays bounded whatever the world size.
+//
+// Every chunk is a pure function of (seed, chunk coordinates), so evicted
+// chunks come back identical and buildings line up across chunk borders.
+class BackgroundStreamer {
+public:
+    static const unsigned int CHUNK_SIZE = 256;
+
+    BackgroundStreamer();
+    ~BackgroundStreamer();
+
+    // Set before the first update
+    void setWorldSize(sf::Vector2f size) { worldSize = size; }
+    void setSeed(std::uint32_t value) { seed = value; }
+
+    // Render thread: requests chunks near the view, uploads finished ones and evicts far ones
+    void update(const sf::FloatRect& viewBounds);
+    void submit(RenderQueue& queue, const sf::FloatRect& viewBounds) const;
+
+    const BackgroundStreamStats& getStats() const { return stats; }
+    // True while chunks are still being generated, i.e. the picture is not final yet
+    bool isStreaming() const { return !pending.empty(); }
+
+private:
+    struct Chunk {
+        int x;
+        int y;
+        std::unique_ptr<sf::Texture> texture;
+    };
+
+    sf::Vector2f worldSize;
+    std::uint32_t seed;
+
+    // Keyed by packChunkKey(x, y)
+    std::map<std::uint32_t, Chunk> resident;
+    std::map<std::uint32_t, std::future<PixelCanvas>> pending;
+    std::vector<std::unique_ptr<sf::Texture>> freeTextures;
+
+    BackgroundStreamStats stats;
+
+    void requestChunks(const sf::FloatRect& viewBounds);
+    void uploadFinishedChunks();
+    void evictChunks(const sf::FloatRect& viewBounds);
+    sf::FloatRect getChunkBounds(int x, int y) const;
+
+    static std::uint32_t packChunkKey(int x, int y);
+    static PixelCanvas generateChunk(int chunkX, int chunkY, sf::Vector2f worldSize, std::uint32_t seed);
+
+    static const float LOAD_DISTANCE;
+    static const float EVICT_DISTANCE;
+    static const std::size_t MAX_PENDING = 6;
+};
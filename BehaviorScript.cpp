@@ -0,0 +1,106 @@
+#include "BehaviorScript.h"
+#include <algorithm>
+#include <new>
+
+ScriptFrameArena::ScriptFrameArena()
+    : chunkCursor(nullptr)
+    , chunkLeft(0)
+    , liveCount(0)
+    , peakCount(0) {
+    std::fill(freeLists, freeLists + CLASS_COUNT, nullptr);
+}
+
+ScriptFrameArena& ScriptFrameArena::local() {
+    thread_local ScriptFrameArena arena;
+    return arena;
+}
+
+void* ScriptFrameArena::allocate(std::size_t size) {
+    ++liveCount;
+    peakCount = std::max(peakCount, liveCount);
+
+    const std::size_t sizeClass = (size + CLASS_BYTES - 1) / CLASS_BYTES - 1;
+    if (sizeClass >= CLASS_COUNT) {
+        return ::operator new(size);
+    }
+
+    if (FreeFrame* frame = freeLists[sizeClass]) {
+        freeLists[sizeClass] = frame->next;
+        return frame;
+    }
+
+    // Carve a new frame; what is left of a chunk too small for it is wasted
+    const std::size_t bytes = (sizeClass + 1) * CLASS_BYTES;
+    if (chunkLeft < bytes) {
+        chunks.push_back(std::make_unique<unsigned char[]>(CHUNK_BYTES));
+        chunkCursor = chunks.back().get();
+        chunkLeft = CHUNK_BYTES;
+    }
+    void* frame = chunkCursor;
+    chunkCursor += bytes;
+    chunkLeft -= bytes;
+    return frame;
+}
+
+void ScriptFrameArena::release(void* frame, std::size_t size) {
+    --liveCount;
+
+    const std::size_t sizeClass = (size + CLASS_BYTES - 1) / CLASS_BYTES - 1;
+    if (sizeClass >= CLASS_COUNT) {
+        ::operator delete(frame);
+        return;
+    }
+
+    FreeFrame* freeFrame = static_cast<FreeFrame*>(frame);
+    freeFrame->next = freeLists[sizeClass];
+    freeLists[sizeClass] = freeFrame;
+}
+
+void ScriptCondition::set() {
+    value = true;
+
+    // Only the scripts waiting now; one that waits again is left for the next set().
+    // Resumed one at a time, since a resumed script may stop others in the batch.
+    resuming.insert(resuming.end(), waiters.begin(), waiters.end());
+    waiters.clear();
+    while (!resuming.empty()) {
+        const std::coroutine_handle<> handle = resuming.front();
+        resuming.erase(resuming.begin());
+        handle.resume();
+    }
+}
+
+BehaviorScript& BehaviorScript::operator=(BehaviorScript&& other) noexcept {
+    if (this != &other) {
+        if (handle) {
+            handle.destroy();
+        }
+        handle = other.handle;
+        other.handle = nullptr;
+    }
+    return *this;
+}
+
+BehaviorScript::~BehaviorScript() {
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+void ScriptScheduler::WaitAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    timer = timers.schedule(seconds, [handle] { handle.resume(); });
+}
+
+ScriptScheduler::UntilAwaiter::~UntilAwaiter() {
+    if (handle) {
+        std::vector<std::coroutine_handle<>>& waiters = condition.waiters;
+        std::vector<std::coroutine_handle<>>& resuming = condition.resuming;
+        waiters.erase(std::remove(waiters.begin(), waiters.end(), handle), waiters.end());
+        resuming.erase(std::remove(resuming.begin(), resuming.end(), handle), resuming.end());
+    }
+}
+
+void ScriptScheduler::UntilAwaiter::await_suspend(std::coroutine_handle<> waiting) {
+    handle = waiting;
+    condition.waiters.push_back(waiting);
+}
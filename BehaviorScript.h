@@ -0,0 +1,146 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <vector>
+#include "TimingWheel.h"
+
+// Pool for coroutine frames. Sizes are rounded up to 64-byte classes carved
+// from 16 KB chunks, and a released frame goes on its class's free list, so
+// scripts that start and stop all the time keep reusing the same memory.
+// Each thread has its own; scripts only ever run on the simulation thread.
+class ScriptFrameArena {
+public:
+    ScriptFrameArena();
+
+    static ScriptFrameArena& local();
+
+    void* allocate(std::size_t size);
+    void release(void* frame, std::size_t size);
+
+    std::size_t getLiveCount() const { return liveCount; }
+    std::size_t getPeakCount() const { return peakCount; }
+    std::size_t getChunkCount() const { return chunks.size(); }
+
+private:
+    static const std::size_t CLASS_BYTES = 64;
+    static const std::size_t CLASS_COUNT = 16; // Frames up to 1 KB; larger ones come from the heap
+    static const std::size_t CHUNK_BYTES = 16384;
+
+    struct FreeFrame {
+        FreeFrame* next;
+    };
+
+    FreeFrame* freeLists[CLASS_COUNT];
+    std::vector<std::unique_ptr<unsigned char[]>> chunks;
+    unsigned char* chunkCursor;
+    std::size_t chunkLeft;
+    std::size_t liveCount;
+    std::size_t peakCount;
+};
+
+// A flag scripts can wait for with ScriptScheduler::until(). Setting it
+// resumes the scripts waiting at that moment, in the order they began to
+// wait; it must outlive them.
+class ScriptCondition {
+public:
+    ScriptCondition() : value(false) {}
+
+    void set();
+    void reset() { value = false; }
+    bool isSet() const { return value; }
+
+private:
+    friend class ScriptScheduler;
+
+    bool value;
+    std::vector<std::coroutine_handle<>> waiters;
+    std::vector<std::coroutine_handle<>> resuming; // Taken from waiters by set(), not yet resumed
+};
+
+// Owns one running behavior script, a coroutine returning BehaviorScript.
+// The script runs at once up to its first co_await; destroying the
+// BehaviorScript stops it wherever it is waiting.
+class BehaviorScript {
+public:
+    struct promise_type {
+        BehaviorScript get_return_object() {
+            return BehaviorScript(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        // Frames come from the thread's ScriptFrameArena
+        static void* operator new(std::size_t size) { return ScriptFrameArena::local().allocate(size); }
+        static void operator delete(void* frame, std::size_t size) { ScriptFrameArena::local().release(frame, size); }
+    };
+
+    BehaviorScript() = default;
+    BehaviorScript(BehaviorScript&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    BehaviorScript& operator=(BehaviorScript&& other) noexcept;
+    BehaviorScript(const BehaviorScript&) = delete;
+    BehaviorScript& operator=(const BehaviorScript&) = delete;
+    ~BehaviorScript();
+
+    bool isDone() const { return !handle || handle.done(); }
+
+private:
+    explicit BehaviorScript(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Resumes behavior scripts when what they wait for happens: a timing wheel
+// timer for wait(), ScriptCondition::set() for until(). Nothing polls a
+// waiting script, so an idle one costs only its frame.
+class ScriptScheduler {
+public:
+    // co_await scripts.wait(seconds); at least one tick
+    class WaitAwaiter {
+    public:
+        WaitAwaiter(TimingWheel& timers, float seconds) : timers(timers), seconds(seconds) {}
+        WaitAwaiter(const WaitAwaiter&) = delete;
+        WaitAwaiter& operator=(const WaitAwaiter&) = delete;
+        // Cancels the timer when the script is destroyed while waiting
+        ~WaitAwaiter() { timers.cancel(timer); }
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+
+    private:
+        TimingWheel& timers;
+        float seconds;
+        TimerHandle timer;
+    };
+
+    // co_await scripts.until(condition); carries straight on if it is already set
+    class UntilAwaiter {
+    public:
+        explicit UntilAwaiter(ScriptCondition& condition) : condition(condition) {}
+        UntilAwaiter(const UntilAwaiter&) = delete;
+        UntilAwaiter& operator=(const UntilAwaiter&) = delete;
+        // Leaves the condition's waiters when the script is destroyed while waiting
+        ~UntilAwaiter();
+
+        bool await_ready() const noexcept { return condition.isSet(); }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+
+    private:
+        ScriptCondition& condition;
+        std::coroutine_handle<> handle;
+    };
+
+    explicit ScriptScheduler(TimingWheel& timers) : timers(timers) {}
+
+    WaitAwaiter wait(float seconds) { return WaitAwaiter(timers, seconds); }
+    UntilAwaiter until(ScriptCondition& condition) { return UntilAwaiter(condition); }
+
+private:
+    TimingWheel& timers;
+};
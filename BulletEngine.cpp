@@ -0,0 +1,264 @@
+#include "BulletEngine.h"
+#include "RenderSnapshot.h"
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cmath>
+
+// Sizes and motion follow ProjectileType::BossAttack, scaled down for barrages
+const float BulletEngine::CELL_SIZE = 64.0f;
+const float BulletEngine::RADIUS = 6.0f;
+const float BulletEngine::DAMAGE = 5.0f;
+const float BulletEngine::LIFETIME = 5.0f;
+const float BulletEngine::WOBBLE_FREQUENCY = 8.0f;
+const float BulletEngine::WOBBLE_ACCELERATION = 20.0f;
+const float BulletEngine::PULSE_FREQUENCY = 10.0f;
+
+namespace {
+
+constexpr float PI = 3.14159265f;
+
+// Parabolic sine for angles of zero and up, within 0.06 of std::sin. Enough for
+// the wobble, and unlike std::sin the update loop still vectorises around it.
+inline float approximateSin(float radians) {
+    const float turns = radians * (1.0f / (2.0f * PI));
+    const float u = 2.0f * (turns - static_cast<float>(static_cast<int>(turns))) - 1.0f;
+    return -4.0f * u * (1.0f - std::fabs(u));
+}
+
+// Unit octagon for the core and the aura, 6 triangles each
+const sf::Vector2f OCTAGON[8] = {
+    sf::Vector2f(0.0f, -1.0f), sf::Vector2f(0.7071f, -0.7071f), sf::Vector2f(1.0f, 0.0f), sf::Vector2f(0.7071f, 0.7071f),
+    sf::Vector2f(0.0f, 1.0f), sf::Vector2f(-0.7071f, 0.7071f), sf::Vector2f(-1.0f, 0.0f), sf::Vector2f(-0.7071f, -0.7071f)
+};
+const std::size_t VERTICES_PER_BULLET = 2 * 6 * 3;
+
+sf::Vertex* writeOctagon(sf::Vertex* out, sf::Vector2f center, float radius, const sf::Color& color) {
+    const sf::Vector2f first = center + OCTAGON[0] * radius;
+    sf::Vector2f previous = center + OCTAGON[1] * radius;
+    for (int i = 2; i < 8; ++i) {
+        const sf::Vector2f current = center + OCTAGON[i] * radius;
+        *out++ = sf::Vertex(first, color);
+        *out++ = sf::Vertex(previous, color);
+        *out++ = sf::Vertex(current, color);
+        previous = current;
+    }
+    return out;
+}
+
+}
+
+BulletEngine::BulletEngine(const sf::FloatRect& worldBounds)
+    : positionX(MAX_BULLETS)
+    , positionY(MAX_BULLETS)
+    , velocityX(MAX_BULLETS)
+    , velocityY(MAX_BULLETS)
+    , age(MAX_BULLETS)
+    , curl(MAX_BULLETS)
+    , cell(MAX_BULLETS)
+    , count(0)
+    , worldBounds(worldBounds)
+    , columns(std::max(1, static_cast<int>(std::ceil(worldBounds.width / CELL_SIZE))))
+    , rows(std::max(1, static_cast<int>(std::ceil(worldBounds.height / CELL_SIZE))))
+    , cellStart(columns * rows + 1, 0)
+    , cellFill(columns * rows, 0)
+    , cellBullets(MAX_BULLETS) {
+}
+
+void BulletEngine::fire(const BulletVolley& volley) {
+    if (volley.count <= 0) {
+        return;
+    }
+
+    switch (volley.pattern) {
+        case BulletPattern::Ring:
+        case BulletPattern::Spiral: {
+            const float step = 2.0f * PI / volley.count;
+            const float bulletCurl = volley.pattern == BulletPattern::Spiral ? volley.curl : 0.0f;
+            for (int i = 0; i < volley.count; ++i) {
+                add(volley.origin, volley.angle + i * step, volley.speed, bulletCurl);
+            }
+            break;
+        }
+
+        case BulletPattern::AimedSpread: {
+            const sf::Vector2f toTarget = volley.target - volley.origin;
+            const float aim = std::atan2(toTarget.y, toTarget.x);
+            const float step = volley.count > 1 ? volley.spread / (volley.count - 1) : 0.0f;
+            const float first = volley.count > 1 ? aim - volley.spread * 0.5f : aim;
+            for (int i = 0; i < volley.count; ++i) {
+                add(volley.origin, first + i * step, volley.speed, 0.0f);
+            }
+            break;
+        }
+    }
+}
+
+void BulletEngine::add(sf::Vector2f position, float angle, float speed, float bulletCurl) {
+    if (count == MAX_BULLETS) {
+        ++stats.rejected;
+        return;
+    }
+
+    positionX[count] = position.x;
+    positionY[count] = position.y;
+    velocityX[count] = std::cos(angle) * speed;
+    velocityY[count] = std::sin(angle) * speed;
+    age[count] = 0.0f;
+    curl[count] = bulletCurl;
+    ++count;
+
+    ++stats.fired;
+    stats.peakLive = std::max(stats.peakLive, count);
+}
+
+void BulletEngine::update(float deltaTime) {
+    float* x = positionX.data();
+    float* y = positionY.data();
+    float* vx = velocityX.data();
+    float* vy = velocityY.data();
+    float* bulletAge = age.data();
+    float* bulletCurl = curl.data();
+    const float wobble = WOBBLE_ACCELERATION * deltaTime;
+
+    // Turn the velocities: the curl rotates each one by a small angle (cosine to
+    // second order), and the wobble is the boss attack's vertical sway. Velocity and
+    // position are separate passes so each loop touches few enough arrays to vectorise.
+    for (std::size_t i = 0; i < count; ++i) {
+        const float turn = bulletCurl[i] * deltaTime;
+        const float cosTurn = 1.0f - 0.5f * turn * turn;
+        const float newVx = vx[i] * cosTurn - vy[i] * turn;
+        const float newVy = vx[i] * turn + vy[i] * cosTurn + approximateSin(bulletAge[i] * WOBBLE_FREQUENCY) * wobble;
+        vx[i] = newVx;
+        vy[i] = newVy;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        x[i] += vx[i] * deltaTime;
+        y[i] += vy[i] * deltaTime;
+        bulletAge[i] += deltaTime;
+    }
+
+    // Drop bullets that expired or left the world, keeping the rest in order.
+    // Nothing moves until the first dropped one, which on most ticks is none.
+    const float left = worldBounds.left;
+    const float top = worldBounds.top;
+    const float right = left + worldBounds.width;
+    const float bottom = top + worldBounds.height;
+    auto alive = [&](std::size_t i) {
+        return bulletAge[i] < LIFETIME && x[i] >= left && x[i] < right && y[i] >= top && y[i] < bottom;
+    };
+    std::size_t live = 0;
+    while (live < count && alive(live)) {
+        ++live;
+    }
+    for (std::size_t i = live; i < count; ++i) {
+        if (alive(i)) {
+            x[live] = x[i];
+            y[live] = y[i];
+            vx[live] = vx[i];
+            vy[live] = vy[i];
+            bulletAge[live] = bulletAge[i];
+            bulletCurl[live] = bulletCurl[i];
+            ++live;
+        }
+    }
+    count = live;
+
+    buildGrid();
+}
+
+void BulletEngine::buildGrid() {
+    // Cell of every bullet, then a counting sort of bullet indices by cell
+    const float cellScale = 1.0f / CELL_SIZE;
+    for (std::size_t i = 0; i < count; ++i) {
+        const int column = std::min(columns - 1, static_cast<int>((positionX[i] - worldBounds.left) * cellScale));
+        const int row = std::min(rows - 1, static_cast<int>((positionY[i] - worldBounds.top) * cellScale));
+        cell[i] = static_cast<std::uint32_t>(row * columns + column);
+    }
+
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        ++cellStart[cell[i] + 1];
+    }
+    for (std::size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+
+    std::copy(cellStart.begin(), cellStart.end() - 1, cellFill.begin());
+    for (std::size_t i = 0; i < count; ++i) {
+        cellBullets[cellFill[cell[i]]++] = static_cast<std::uint32_t>(i);
+    }
+}
+
+void BulletEngine::clear() {
+    count = 0;
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+}
+
+std::size_t BulletEngine::collide(const sf::FloatRect& area) {
+    // Cells the area covers once grown by the bullet radius
+    const float cellScale = 1.0f / CELL_SIZE;
+    const int firstColumn = std::max(0, static_cast<int>(std::floor((area.left - RADIUS - worldBounds.left) * cellScale)));
+    const int lastColumn = std::min(columns - 1, static_cast<int>(std::floor((area.left + area.width + RADIUS - worldBounds.left) * cellScale)));
+    const int firstRow = std::max(0, static_cast<int>(std::floor((area.top - RADIUS - worldBounds.top) * cellScale)));
+    const int lastRow = std::min(rows - 1, static_cast<int>(std::floor((area.top + area.height + RADIUS - worldBounds.top) * cellScale)));
+
+    const float right = area.left + area.width;
+    const float bottom = area.top + area.height;
+    std::size_t hits = 0;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const std::size_t c = static_cast<std::size_t>(row * columns + column);
+            for (std::uint32_t k = cellStart[c]; k < cellStart[c + 1]; ++k) {
+                const std::uint32_t i = cellBullets[k];
+                if (age[i] >= LIFETIME) {
+                    continue; // Already removed this tick
+                }
+
+                // Circle against rectangle: distance to the nearest point of the area
+                const float dx = positionX[i] - std::max(area.left, std::min(positionX[i], right));
+                const float dy = positionY[i] - std::max(area.top, std::min(positionY[i], bottom));
+                if (dx * dx + dy * dy <= RADIUS * RADIUS) {
+                    age[i] = LIFETIME; // Dropped by the next update
+                    ++hits;
+                }
+            }
+        }
+    }
+
+    stats.hits += hits;
+    return hits;
+}
+
+void BulletEngine::writeSnapshot(std::vector<BulletSnapshot>& snapshots) const {
+    snapshots.reserve(snapshots.size() + count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (age[i] < LIFETIME) {
+            snapshots.push_back(BulletSnapshot{ sf::Vector2f(positionX[i], positionY[i]), age[i] });
+        }
+    }
+}
+
+void BulletEngine::render(const std::vector<BulletSnapshot>& snapshots, const std::vector<std::uint32_t>& visible,
+                          std::vector<sf::Vertex>& vertices, RenderQueue& queue) {
+    // Dark energy balls: a faint aura behind a pulsing core that fades out over the lifetime
+    vertices.resize(visible.size() * VERTICES_PER_BULLET);
+    sf::Vertex* out = vertices.data();
+    for (std::uint32_t index : visible) {
+        const BulletSnapshot& bullet = snapshots[index];
+        const float radius = RADIUS * (1.0f + 0.3f * std::sin(bullet.age * PULSE_FREQUENCY));
+        const float fade = std::max(0.0f, 1.0f - bullet.age / LIFETIME);
+
+        out = writeOctagon(out, bullet.position, radius * 1.5f, sf::Color(255, 0, 255, 32));
+        out = writeOctagon(out, bullet.position, radius, sf::Color(255, 0, 255, static_cast<sf::Uint8>(255 * fade)));
+    }
+
+    if (!vertices.empty()) {
+        queue.submit(RenderLayer::Projectiles, vertices.data(), vertices.size(), sf::Triangles);
+    }
+}
+
+sf::FloatRect BulletEngine::getRenderBounds(const BulletSnapshot& snapshot) {
+    // Aura at full pulse
+    const float extent = RADIUS * 1.3f * 1.5f;
+    return sf::FloatRect(snapshot.position.x - extent, snapshot.position.y - extent, extent * 2, extent * 2);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct BulletSnapshot;
+class RenderQueue;
+
+enum class BulletPattern : std::uint8_t {
+    Ring,       // Evenly around the origin, the first bullet at angle
+    Spiral,     // A ring of curling bullets; fired again and again with a turning angle it draws a spiral
+    AimedSpread // Fanned across spread radians, centred on the target
+};
+
+struct BulletVolley {
+    BulletPattern pattern = BulletPattern::Ring;
+    sf::Vector2f origin;
+    sf::Vector2f target;
+    int count = 0;
+    float speed = 0.0f;
+    float angle = 0.0f;  // Radians
+    float spread = 0.0f; // Radians
+    float curl = 0.0f;   // Spiral only: radians per second each bullet turns by
+};
+
+struct BulletStats {
+    std::size_t fired = 0;
+    std::size_t rejected = 0; // Not fired because the engine was full
+    std::size_t hits = 0;     // Removed by collide()
+    std::size_t peakLive = 0;
+};
+
+// Hostile bullets (the boss energy balls), kept apart from the Projectile
+// objects so a barrage can reach tens of thousands of them.
+//
+// Bullets are stored as parallel arrays and moved in straight passes over
+// them each tick, which then drop expired bullets and file the rest into a
+// uniform grid over the world, so collide() only looks at the cells an area covers.
+// All bullets share one size, damage and lifetime.
+class BulletEngine {
+public:
+    static const std::size_t MAX_BULLETS = 50000;
+
+    explicit BulletEngine(const sf::FloatRect& worldBounds);
+
+    // Bullets past MAX_BULLETS are dropped (and counted as rejected)
+    void fire(const BulletVolley& volley);
+    void update(float deltaTime);
+    void clear();
+
+    // Removes every bullet touching area and returns how many there were.
+    // Only sees bullets filed by the last update().
+    std::size_t collide(const sf::FloatRect& area);
+
+    // Rendering works from snapshots so it can run on the render thread.
+    // Visible bullets are built into vertices and submitted as one batch.
+    void writeSnapshot(std::vector<BulletSnapshot>& snapshots) const;
+    static void render(const std::vector<BulletSnapshot>& snapshots, const std::vector<std::uint32_t>& visible,
+                       std::vector<sf::Vertex>& vertices, RenderQueue& queue);
+    static sf::FloatRect getRenderBounds(const BulletSnapshot& snapshot);
+
+    std::size_t getLiveCount() const { return count; }
+    const BulletStats& getStats() const { return stats; }
+    static float getDamage() { return DAMAGE; }
+
+private:
+    // Parallel arrays, MAX_BULLETS long; the first count entries are live
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<float> age;
+    std::vector<float> curl;
+    std::vector<std::uint32_t> cell;
+    std::size_t count;
+
+    // Grid cell c holds cellBullets[cellStart[c] .. cellStart[c + 1])
+    sf::FloatRect worldBounds;
+    int columns;
+    int rows;
+    std::vector<std::uint32_t> cellStart;
+    std::vector<std::uint32_t> cellFill;
+    std::vector<std::uint32_t> cellBullets;
+
+    BulletStats stats;
+
+    void add(sf::Vector2f position, float angle, float speed, float bulletCurl);
+    void buildGrid();
+
+    static const float CELL_SIZE;
+    static const float RADIUS;
+    static const float DAMAGE;
+    static const float LIFETIME;
+    static const float WOBBLE_FREQUENCY;
+    static const float WOBBLE_ACCELERATION;
+    static const float PULSE_FREQUENCY;
+};
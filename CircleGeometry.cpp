@@ -0,0 +1,48 @@
+#include "CircleGeometry.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const float PI = 3.14159265f;
+
+    // Largest distance allowed between the polygon edge and the true circle
+    const float MAX_ERROR_PIXELS = 0.25f;
+}
+
+const std::size_t CircleGeometry::MIN_POINTS;
+const std::size_t CircleGeometry::MAX_POINTS;
+
+const std::vector<sf::Vector2f>& CircleGeometry::getUnitCircle(float screenRadius) {
+    const std::size_t bucket = getBucket(screenRadius);
+    std::vector<sf::Vector2f>& table = tables[bucket];
+    if (table.empty()) {
+        const std::size_t pointCount = getBucketPointCount(bucket);
+        table.resize(pointCount);
+        for (std::size_t i = 0; i < pointCount; ++i) {
+            float angle = i * 2.0f * PI / pointCount - PI / 2.0f;
+            table[i] = sf::Vector2f(std::cos(angle), std::sin(angle));
+        }
+    }
+    return table;
+}
+
+std::size_t CircleGeometry::getPointCount(float screenRadius) {
+    return getBucketPointCount(getBucket(screenRadius));
+}
+
+std::size_t CircleGeometry::getBucket(float screenRadius) {
+    if (screenRadius <= 1.0f) {
+        return 0;
+    }
+    // Half-octave steps: bucket b covers radii up to 2^(b/2)
+    const float steps = std::ceil(2.0f * std::log2(screenRadius));
+    return std::min(static_cast<std::size_t>(steps), BUCKET_COUNT - 1);
+}
+
+std::size_t CircleGeometry::getBucketPointCount(std::size_t bucket) {
+    // Sagitta r * (1 - cos(pi / n)) <= error, evaluated at the bucket's largest radius
+    const float radius = std::pow(2.0f, bucket * 0.5f);
+    const float ratio = std::max(1.0f - MAX_ERROR_PIXELS / radius, -1.0f);
+    const float points = std::ceil(PI / std::acos(ratio));
+    return std::max(MIN_POINTS, std::min(MAX_POINTS, static_cast<std::size_t>(points)));
+}
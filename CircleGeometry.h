@@ -0,0 +1,29 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Shared unit-circle tables for tessellating circles. On-screen radii are
+// quantized into half-octave buckets; each bucket gets just enough points to
+// keep the polygon within a quarter pixel of a true circle (6 points for
+// sparks, 48 for large auras), and its table is built once and reused.
+class CircleGeometry {
+public:
+    static const std::size_t MIN_POINTS = 6;
+    static const std::size_t MAX_POINTS = 48;
+
+    // Unit circle points, starting at the top like sf::CircleShape
+    const std::vector<sf::Vector2f>& getUnitCircle(float screenRadius);
+
+    static std::size_t getPointCount(float screenRadius);
+
+private:
+    static const std::size_t BUCKET_COUNT = 16;
+
+    std::array<std::vector<sf::Vector2f>, BUCKET_COUNT> tables;
+
+    static std::size_t getBucket(float screenRadius);
+    static std::size_t getBucketPointCount(std::size_t bucket);
+};
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COMPACT_PARTICLE_SSE2 1
+#endif
+
+// Particles in 20 bytes each. Everything that can be derived is: the origin and
+// type live in a shared emitter record, colour is a palette index, alpha, size
+// growth and rotation follow from the normalised age.
+//
+//  offset    fixed point, 1/32 px, relative to the emitter origin (+-1024 px)
+//  velocity  px/s, full floats: the update reads and writes them every step
+//  age       0..AGE_END over the lifetime
+//  lifetime  1/32 s (up to ~8 s)
+//  size      size at birth, 1/8 px (up to ~32 px)
+//  spin      rotation speed, 3 degrees/s
+//
+// Header-only and SFML-free so tools/ParticleBench.cpp measures the same code.
+struct CompactParticle {
+    std::int16_t offsetX;
+    std::int16_t offsetY;
+    float velocityX;
+    float velocityY;
+    std::uint16_t age;
+    std::uint16_t emitter;
+    std::uint8_t lifetime;
+    std::uint8_t color;
+    std::uint8_t size;
+    std::int8_t spin;
+
+    static constexpr int POSITION_SCALE = 32;
+    static constexpr int LIFETIME_SCALE = 32;
+    static constexpr int SIZE_SCALE = 8;
+    static constexpr int SPIN_SCALE = 3;
+    static constexpr std::uint32_t AGE_END = 0xFFFF;
+
+    // Moves an offset by a fraction of a unit: rounds down after adding dither in [0, 1).
+    // A fresh dither every step rounds without bias, so slow particles still cover the
+    // right distance at under a unit per step. Clamped to the representable range.
+    static std::int16_t moveOffset(std::int16_t offset, float pixels, float dither) {
+        // Truncating a positive value rounds down without a floor() call
+        const float step = std::min(std::max(pixels * POSITION_SCALE + dither + 65536.0f, 0.0f), 131072.0f);
+        const std::int32_t moved = offset + static_cast<std::int32_t>(step) - 65536;
+        return static_cast<std::int16_t>(std::min(std::max(moved, -32768), 32767));
+    }
+
+    // 6x7x6 colour cube: 252 entries, green gets the extra level
+    static std::uint8_t toPaletteIndex(std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+        return static_cast<std::uint8_t>(((r * 5 + 127) / 255) * 42 + ((g * 6 + 127) / 255) * 6 + (b * 5 + 127) / 255);
+    }
+    static void fromPaletteIndex(std::uint8_t index, std::uint8_t& r, std::uint8_t& g, std::uint8_t& b) {
+        r = static_cast<std::uint8_t>(index / 42 * 51);
+        g = static_cast<std::uint8_t>(index / 6 % 7 * 255 / 6);
+        b = static_cast<std::uint8_t>(index % 6 * 51);
+    }
+};
+
+// CompactParticles stored one array per field, so the update loads a field of eight
+// particles with one instruction and never touches what only snapshots read.
+// remove() swaps the last particle into the hole, as in every packed array here.
+struct CompactParticleArray {
+    std::vector<std::int16_t> offsetX;
+    std::vector<std::int16_t> offsetY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<std::uint16_t> age;
+    std::vector<std::uint8_t> lifetime;
+    std::vector<std::uint16_t> emitter;
+    std::vector<std::uint8_t> color;
+    std::vector<std::uint8_t> size;
+    std::vector<std::int8_t> spin;
+
+    std::size_t count() const { return age.size(); }
+    bool isDead(std::size_t i) const { return age[i] >= CompactParticle::AGE_END; }
+    float getAge(std::size_t i) const { return age[i] * (1.0f / CompactParticle::AGE_END); }
+    float getElapsed(std::size_t i) const { return getAge(i) * lifetime[i] * (1.0f / CompactParticle::LIFETIME_SCALE); }
+
+    void add(const CompactParticle& particle) {
+        offsetX.push_back(particle.offsetX);
+        offsetY.push_back(particle.offsetY);
+        velocityX.push_back(particle.velocityX);
+        velocityY.push_back(particle.velocityY);
+        age.push_back(particle.age);
+        lifetime.push_back(particle.lifetime);
+        emitter.push_back(particle.emitter);
+        color.push_back(particle.color);
+        size.push_back(particle.size);
+        spin.push_back(particle.spin);
+    }
+
+    void remove(std::size_t index) {
+        const std::size_t last = count() - 1;
+        offsetX[index] = offsetX[last];
+        offsetY[index] = offsetY[last];
+        velocityX[index] = velocityX[last];
+        velocityY[index] = velocityY[last];
+        age[index] = age[last];
+        lifetime[index] = lifetime[last];
+        emitter[index] = emitter[last];
+        color[index] = color[last];
+        size[index] = size[last];
+        spin[index] = spin[last];
+        offsetX.pop_back();
+        offsetY.pop_back();
+        velocityX.pop_back();
+        velocityY.pop_back();
+        age.pop_back();
+        lifetime.pop_back();
+        emitter.pop_back();
+        color.pop_back();
+        size.pop_back();
+        spin.pop_back();
+    }
+
+    void clear() {
+        offsetX.clear();
+        offsetY.clear();
+        velocityX.clear();
+        velocityY.clear();
+        age.clear();
+        lifetime.clear();
+        emitter.clear();
+        color.clear();
+        size.clear();
+        spin.clear();
+    }
+};
+
+// 1 / lifetime for every byte value. A zero lifetime gets 1, which ends the particle in one step.
+struct LifetimeReciprocals {
+    float values[256];
+
+    constexpr LifetimeReciprocals() : values() {
+        values[0] = 1.0f;
+        for (int i = 1; i < 256; ++i) {
+            values[i] = 1.0f / i;
+        }
+    }
+};
+
+inline constexpr LifetimeReciprocals LIFETIME_RECIPROCALS;
+
+// One simulation step for particle i: constant vertical acceleration and drag for the
+// step, then integrate and age. Returns false once the particle has reached the end of
+// its life. There is no early exit, so a loop over a bucket of particles stays
+// branch-free; a particle that dies this step moves once more, which nothing ever draws.
+inline bool advanceParticle(CompactParticleArray& particles, std::size_t i, float accelerationY, float drag,
+                            float deltaTime) {
+    // Lifetime is a byte, so the age step is a multiply rather than a divide
+    const float ageStep = deltaTime * (CompactParticle::AGE_END * CompactParticle::LIFETIME_SCALE);
+    const std::uint32_t age = std::min(CompactParticle::AGE_END, particles.age[i] + static_cast<std::uint32_t>(
+        ageStep * LIFETIME_RECIPROCALS.values[particles.lifetime[i]] + 0.5f));
+    particles.age[i] = static_cast<std::uint16_t>(age);
+
+    // The age changes every step, so hashing it gives a cheap per-step dither
+    const std::uint32_t hash = (age * 2654435761u) >> 16;
+    const float ditherX = (hash & 0xFF) * (1.0f / 256.0f);
+    const float ditherY = (hash >> 8 & 0xFF) * (1.0f / 256.0f);
+
+    const float velocityX = particles.velocityX[i];
+    const float velocityY = particles.velocityY[i];
+    particles.offsetX[i] = CompactParticle::moveOffset(particles.offsetX[i], velocityX * deltaTime, ditherX);
+    particles.offsetY[i] = CompactParticle::moveOffset(particles.offsetY[i], velocityY * deltaTime, ditherY);
+
+    particles.velocityX[i] = velocityX * drag;
+    particles.velocityY[i] = (velocityY + accelerationY * deltaTime) * drag;
+    return age < CompactParticle::AGE_END;
+}
+
+#ifdef COMPACT_PARTICLE_SSE2
+// SSE2 form of advanceParticle, four lanes of 32 bits at a time; each helper
+// matches its scalar counterpart bit for bit.
+namespace CompactParticleSse2 {
+    inline __m128i widenUnsigned(__m128i words, bool high) {
+        return high ? _mm_unpackhi_epi16(words, _mm_setzero_si128()) : _mm_unpacklo_epi16(words, _mm_setzero_si128());
+    }
+
+    inline __m128i widenSigned(__m128i words, bool high) {
+        return _mm_srai_epi32(high ? _mm_unpackhi_epi16(words, words) : _mm_unpacklo_epi16(words, words), 16);
+    }
+
+    // The offset before saturating to 16 bits, which does the rest of the scalar clamp
+    inline __m128i moveOffset(__m128i offset, __m128 units, __m128 dither) {
+        __m128 step = _mm_add_ps(_mm_add_ps(units, dither), _mm_set1_ps(65536.0f));
+        step = _mm_min_ps(_mm_max_ps(step, _mm_setzero_ps()), _mm_set1_ps(131072.0f));
+        return _mm_add_epi32(offset, _mm_sub_epi32(_mm_cvttps_epi32(step), _mm_set1_epi32(65536)));
+    }
+
+    // The age step for four lifetimes, clamped to AGE_END and offset by -0x8000 for a signed pack
+    inline __m128i ageDelta(__m128 ageStep, __m128i lifetime) {
+        const __m128 reciprocal = _mm_div_ps(_mm_set1_ps(1.0f), _mm_max_ps(_mm_cvtepi32_ps(lifetime), _mm_set1_ps(1.0f)));
+        const __m128 delta = _mm_min_ps(_mm_add_ps(_mm_mul_ps(ageStep, reciprocal), _mm_set1_ps(0.5f)),
+                                        _mm_set1_ps(static_cast<float>(CompactParticle::AGE_END)));
+        return _mm_sub_epi32(_mm_cvttps_epi32(delta), _mm_set1_epi32(0x8000));
+    }
+}
+#endif
+
+// advanceParticle over every particle in the array, eight at a time with SSE2
+inline void advanceParticles(CompactParticleArray& particles, float accelerationY, float drag, float deltaTime) {
+    const std::size_t count = particles.count();
+    std::size_t i = 0;
+#ifdef COMPACT_PARTICLE_SSE2
+    namespace simd = CompactParticleSse2;
+    const __m128 ageStep = _mm_set1_ps(deltaTime * (CompactParticle::AGE_END * CompactParticle::LIFETIME_SCALE));
+    // Scaling by a power of two rounds the same before or after the multiply by the velocity
+    const __m128 units = _mm_set1_ps(deltaTime * CompactParticle::POSITION_SCALE);
+    const __m128 gravity = _mm_set1_ps(accelerationY * deltaTime);
+    const __m128 dragScale = _mm_set1_ps(drag);
+    const __m128 ditherScale = _mm_set1_ps(1.0f / 256.0f);
+    for (; i + 8 <= count; i += 8) {
+        // Age, in unsigned 16 bits: a saturating add is the clamp to AGE_END
+        const __m128i lifetime = _mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(particles.lifetime.data() + i)), _mm_setzero_si128());
+        const __m128i ageDelta = _mm_xor_si128(_mm_packs_epi32(simd::ageDelta(ageStep, simd::widenUnsigned(lifetime, false)),
+                                                               simd::ageDelta(ageStep, simd::widenUnsigned(lifetime, true))),
+                                               _mm_set1_epi16(-0x8000));
+        __m128i* age = reinterpret_cast<__m128i*>(particles.age.data() + i);
+        const __m128i aged = _mm_adds_epu16(_mm_loadu_si128(age), ageDelta);
+        _mm_storeu_si128(age, aged);
+
+        // Bits 16-31 of age * 2654435761u, from 16-bit multiplies
+        const __m128i hash = _mm_add_epi16(_mm_mulhi_epu16(aged, _mm_set1_epi16(0x79B1)),
+                                           _mm_mullo_epi16(aged, _mm_set1_epi16(static_cast<short>(0x9E37))));
+        const __m128i ditherX = _mm_and_si128(hash, _mm_set1_epi16(0xFF));
+        const __m128i ditherY = _mm_srli_epi16(hash, 8);
+
+        __m128i* offsetX = reinterpret_cast<__m128i*>(particles.offsetX.data() + i);
+        __m128i* offsetY = reinterpret_cast<__m128i*>(particles.offsetY.data() + i);
+        const __m128i oldX = _mm_loadu_si128(offsetX);
+        const __m128i oldY = _mm_loadu_si128(offsetY);
+        __m128i movedX[2];
+        __m128i movedY[2];
+        for (int half = 0; half < 2; ++half) {
+            float* velocityX = particles.velocityX.data() + i + half * 4;
+            float* velocityY = particles.velocityY.data() + i + half * 4;
+            const __m128 x = _mm_loadu_ps(velocityX);
+            const __m128 y = _mm_loadu_ps(velocityY);
+            movedX[half] = simd::moveOffset(simd::widenSigned(oldX, half != 0), _mm_mul_ps(x, units),
+                                            _mm_mul_ps(_mm_cvtepi32_ps(simd::widenUnsigned(ditherX, half != 0)), ditherScale));
+            movedY[half] = simd::moveOffset(simd::widenSigned(oldY, half != 0), _mm_mul_ps(y, units),
+                                            _mm_mul_ps(_mm_cvtepi32_ps(simd::widenUnsigned(ditherY, half != 0)), ditherScale));
+            _mm_storeu_ps(velocityX, _mm_mul_ps(x, dragScale));
+            _mm_storeu_ps(velocityY, _mm_mul_ps(_mm_add_ps(y, gravity), dragScale));
+        }
+        _mm_storeu_si128(offsetX, _mm_packs_epi32(movedX[0], movedX[1]));
+        _mm_storeu_si128(offsetY, _mm_packs_epi32(movedY[0], movedY[1]));
+    }
+#endif
+    for (; i < count; ++i) {
+        advanceParticle(particles, i, accelerationY, drag, deltaTime);
+    }
+}
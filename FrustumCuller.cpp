@@ -0,0 +1,52 @@
+#include "FrustumCuller.h"
+
+void FrustumCuller::setView(const sf::View& view) {
+    // The inverse view transform maps normalized device coordinates back to the world
+    viewBounds = view.getInverseTransform().transformRect(sf::FloatRect(-1.0f, -1.0f, 2.0f, 2.0f));
+}
+
+void FrustumCuller::clear() {
+    minX.clear();
+    minY.clear();
+    maxX.clear();
+    maxY.clear();
+}
+
+void FrustumCuller::add(const sf::FloatRect& bounds) {
+    minX.push_back(bounds.left);
+    minY.push_back(bounds.top);
+    maxX.push_back(bounds.left + bounds.width);
+    maxY.push_back(bounds.top + bounds.height);
+}
+
+const std::vector<std::uint32_t>& FrustumCuller::cull() {
+    const std::size_t count = minX.size();
+    const float left = viewBounds.left;
+    const float top = viewBounds.top;
+    const float right = viewBounds.left + viewBounds.width;
+    const float bottom = viewBounds.top + viewBounds.height;
+
+    // Overlap test without branches so the loop vectorizes
+    visibility.resize(count);
+    const float* x0 = minX.data();
+    const float* y0 = minY.data();
+    const float* x1 = maxX.data();
+    const float* y1 = maxY.data();
+    std::uint8_t* out = visibility.data();
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<std::uint8_t>((x0[i] <= right) & (x1[i] >= left) &
+                                           (y0[i] <= bottom) & (y1[i] >= top));
+    }
+
+    visible.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (out[i]) {
+            visible.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+
+    frameStats.tested += count;
+    frameStats.drawn += visible.size();
+    frameStats.culled += count - visible.size();
+    return visible;
+}
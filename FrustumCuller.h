@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+struct CullStats {
+    std::size_t tested = 0;
+    std::size_t drawn = 0;
+    std::size_t culled = 0;
+};
+
+// Visibility test of axis-aligned bounding boxes against the current view.
+// Boxes for one batch are gathered into separate min/max arrays and tested
+// in a single branch-free pass, then compacted into a list of visible
+// indices, so nothing is submitted for geometry that is off screen.
+class FrustumCuller {
+public:
+    // World-space rectangle covered by the view (the bounding box if rotated)
+    void setView(const sf::View& view);
+    const sf::FloatRect& getViewBounds() const { return viewBounds; }
+
+    // Batch interface: add boxes, then cull() returns the visible ones by add order
+    void clear();
+    void add(const sf::FloatRect& bounds);
+    const std::vector<std::uint32_t>& cull();
+
+    // Counters across all batches since the last reset (one frame)
+    void resetStats() { frameStats = CullStats(); }
+    const CullStats& getFrameStats() const { return frameStats; }
+
+private:
+    sf::FloatRect viewBounds;
+
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<std::uint8_t> visibility;
+    std::vector<std::uint32_t> visible;
+
+    CullStats frameStats;
+};
@@ -1,18 +1,41 @@
 #include "Game.h"
-#include <iostream>
 #include <random>
 #include <algorithm>
+#include <cmath>
+#include <chrono>
 
 const float Game::TARGET_FPS = 60.0f;
+const float Game::SIMULATION_RATE = 120.0f;
+const float Game::CONTACT_DAMAGE_INTERVAL = 1.0f / 60.0f; // Once per frame of the original 60 FPS loop
+const float Game::CAMERA_FOLLOW_RATE = 6.0f;
+const float Game::STATIC_WAIT_SECONDS = 0.25f;
+const float Game::EVENT_POLL_SECONDS = 0.01f;
+// Render work per frame, leaving the rest of the 60 FPS frame for the swap and the simulation
+const float Game::FRAME_BUDGET_SECONDS = 0.6f / 60.0f;
 
 Game::Game() 
     : window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Superman vs Ghost", sf::Style::Titlebar | sf::Style::Close)
+    , gameView(sf::FloatRect(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT))
     , currentState(GameState::Menu)
     , score(0)
     , level(1)
-    , isMousePressed(false) {
+    , isMousePressed(false)
+    , timers(1.0f / SIMULATION_RATE)
+    , bullets(sf::FloatRect(0, 0, WORLD_WIDTH, WORLD_HEIGHT))
+    , scripts(timers)
+    , renderRunning(false)
+    , quitRequested(false)
+    , simulationTicks(0)
+    , renderedFrames(0)
+    , redrawPending(false)
+    , frozenSceneValid(false)
+    , quality(FRAME_BUDGET_SECONDS)
+    , appliedQualityLevel(-1)
+    , hudRefreshDue(true) {
     
     window.setFramerateLimit(static_cast<unsigned int>(TARGET_FPS));
+    parallax.setWorldHeight(WORLD_HEIGHT);
+    background.setWorldSize(sf::Vector2f(WORLD_WIDTH, WORLD_HEIGHT));
 }
 
 Game::~Game() = default;
@@ -20,19 +43,37 @@ Game::~Game() = default;
 bool Game::initialize() {
     // Initialize resource manager
     if (!resourceManager.initialize()) {
-        std::cerr << "Failed to initialize resource manager!" << std::endl;
+        LOG_ERROR("Game", "Failed to initialize resource manager!");
         return false;
     }
     
-    // Load font
-    if (!font.loadFromFile("assets/fonts/arial.ttf")) {
+    // Load font (from the mapped asset pack when available)
+    const void* packedData = nullptr;
+    std::size_t packedSize = 0;
+    bool fontLoaded = resourceManager.findPackedAsset("fonts/arial.ttf", packedData, packedSize)
+        ? font.loadFromMemory(packedData, packedSize)
+        : font.loadFromFile("assets/fonts/arial.ttf");
+    if (!fontLoaded) {
         // Try to use default font if custom font fails
-        std::cout << "Warning: Could not load custom font, using default font" << std::endl;
+        LOG_WARNING("Game", "Could not load custom font, using default font");
     }
     
+    // Ghost types (stats and AI programs) from data; the built-in types otherwise
+    bool ghostTypesLoaded = resourceManager.findPackedAsset("data/ghosts.txt", packedData, packedSize)
+        ? ghostTypes.loadFromMemory(packedData, packedSize)
+        : ghostTypes.loadFromFile("assets/data/ghosts.txt");
+    if (!ghostTypesLoaded) {
+        LOG_INFO("Game", "No ghost type data loaded, using the built-in types");
+    }
+    ghostAiTimer = timers.schedule(Ghost::AI_INTERVAL, [this] { updateGhostAi(); }, Ghost::AI_INTERVAL);
+    
+    // Ghost contact damage was tuned per frame; on its own timer it keeps that rate at any tick rate
+    contactDamageTimer = timers.schedule(CONTACT_DAMAGE_INTERVAL, [this] { checkSupermanGhostCollisions(); },
+                                         CONTACT_DAMAGE_INTERVAL);
+    
     // Initialize game objects
-    superman = std::make_unique<Superman>(WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f);
-    particleSystem = std::make_unique<ParticleSystem>();
+    superman = std::make_unique<Superman>(WORLD_WIDTH / 2.0f, WORLD_HEIGHT / 2.0f, timers);
+    particleSystem = std::make_unique<ParticleSystem>(timers);
     
     // Initialize UI text
     titleText.setFont(font);
@@ -86,79 +127,256 @@ bool Game::initialize() {
     sf::FloatRect pausedBounds = pausedText.getLocalBounds();
     pausedText.setPosition((WINDOW_WIDTH - pausedBounds.width) / 2, WINDOW_HEIGHT / 2 - 50);
     
-    // Load background
-    sf::Texture* backgroundTexture = resourceManager.getTexture("background");
-    if (backgroundTexture) {
-        backgroundSprite.setTexture(*backgroundTexture);
-        // Scale background to fit window
-        sf::Vector2u textureSize = backgroundTexture->getSize();
-        float scaleX = static_cast<float>(WINDOW_WIDTH) / textureSize.x;
-        float scaleY = static_cast<float>(WINDOW_HEIGHT) / textureSize.y;
-        backgroundSprite.setScale(scaleX, scaleY);
-    }
+    // Dims the frozen scene behind the pause and game over text
+    dimOverlay.setSize(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
+    dimOverlay.setFillColor(sf::Color(0, 0, 0, 128));
     
-    // Initialize audio
-    if (!backgroundMusic.openFromFile("assets/sounds/background_music.ogg")) {
-        std::cout << "Warning: Could not load background music" << std::endl;
+    // The background is streamed in chunks around the camera by the render thread
+    snapCamera();
+    
+    // Initialize audio (music streams straight out of the pack mapping when packed)
+    bool musicOpened = resourceManager.findPackedAsset("sounds/background_music.ogg", packedData, packedSize)
+        ? backgroundMusic.openFromMemory(packedData, packedSize)
+        : backgroundMusic.openFromFile("assets/sounds/background_music.ogg");
+    if (!musicOpened) {
+        LOG_WARNING("Game", "Could not load background music");
     } else {
         backgroundMusic.setLoop(true);
         backgroundMusic.setVolume(30);
     }
     
     // Load sound effects
-    sf::SoundBuffer* laserBuffer = resourceManager.getSoundBuffer("laser");
-    sf::SoundBuffer* punchBuffer = resourceManager.getSoundBuffer("punch");
-    sf::SoundBuffer* ghostDeathBuffer = resourceManager.getSoundBuffer("ghost_death");
+    laserBuffer = resourceManager.acquireSoundBuffer(SoundIds::Laser);
+    punchBuffer = resourceManager.acquireSoundBuffer(SoundIds::Punch);
+    ghostDeathBuffer = resourceManager.acquireSoundBuffer(SoundIds::GhostDeath);
+    
+    soundEffects.setBuffer(SoundEvent::Laser, laserBuffer.get());
+    soundEffects.setBuffer(SoundEvent::Punch, punchBuffer.get());
+    soundEffects.setBuffer(SoundEvent::GhostDeath, ghostDeathBuffer.get());
     
-    if (laserBuffer) laserSound.setBuffer(*laserBuffer);
-    if (punchBuffer) punchSound.setBuffer(*punchBuffer);
-    if (ghostDeathBuffer) ghostDeathSound.setBuffer(*ghostDeathBuffer);
+    // From here on all audio calls go through the audio thread
+    audio.start(soundEffects, backgroundMusic);
+    
+    resourceManager.logMemoryStats();
     
     return true;
 }
 
 void Game::run() {
-    while (window.isOpen()) {
+    // Hand the GL context over to the render thread; events stay on this thread
+    publishSnapshot();
+    window.setActive(false);
+    renderRunning = true;
+    renderThread = std::thread(&Game::renderLoop, this);
+    
+    const sf::Time tickLength = sf::seconds(1.0f / SIMULATION_RATE);
+    while (!quitRequested) {
         float deltaTime = clock.restart().asSeconds();
+        const GameState previousState = currentState;
+        bool redraw = true;
+        
+        if (isStaticState(currentState)) {
+            // Nothing moves, so sleep until input arrives; the wait is not game time
+            redraw = waitForEvents(sf::seconds(STATIC_WAIT_SECONDS));
+            deltaTime = 0.0f;
+            clock.restart();
+        } else {
+            handleEvents();
+        }
         
-        handleEvents();
         update(deltaTime);
-        render();
+        audio.endFrame();
+        if (redraw || currentState != previousState) {
+            publishSnapshot();
+        }
+        ++simulationTicks;
+        
+        // Pace the simulation; the render thread runs at its own rate
+        sf::Time elapsed = clock.getElapsedTime();
+        if (!isStaticState(currentState) && elapsed < tickLength) {
+            sf::sleep(tickLength - elapsed);
+        }
+    }
+    
+    renderRunning = false;
+    redrawSignal.notify_one();
+    renderThread.join();
+    window.setActive(true);
+    window.close();
+    
+    LOG_INFO("Game", "Simulated %llu ticks, rendered %llu frames",
+             static_cast<unsigned long long>(simulationTicks),
+             static_cast<unsigned long long>(renderedFrames));
+    
+    if (renderQueue.getFrameCount() > 0) {
+        const RenderQueueStats& totals = renderQueue.getTotalStats();
+        const double frames = static_cast<double>(renderQueue.getFrameCount());
+        LOG_INFO("Game", "Render queue per frame: %.1f commands, %.1f batches, %.1f draw calls",
+                 totals.submitted / frames, totals.batches / frames, totals.drawCalls / frames);
+    }
+    
+    const BackgroundStreamStats& streaming = background.getStats();
+    LOG_INFO("Game", "Background chunks: %zu generated, %zu evicted, peak %zu resident",
+             streaming.generated, streaming.evicted, streaming.peakResident);
+    LOG_INFO("Game", "Parallax layer textures rendered: %zu", parallax.getRenderCount());
+    
+    const QualityStats& qualityStats = quality.getStats();
+    LOG_INFO("Game", "Quality: ended at %s after %zu downgrades and %zu upgrades",
+             AdaptiveQuality::getSettings(qualityStats.level).name, qualityStats.downgrades, qualityStats.upgrades);
+    
+    const BulletStats& bulletStats = bullets.getStats();
+    LOG_INFO("Game", "Bullets: %zu fired, %zu rejected, %zu hits, peak %zu live",
+             bulletStats.fired, bulletStats.rejected, bulletStats.hits, bulletStats.peakLive);
+    
+    const ScriptFrameArena& scriptFrames = ScriptFrameArena::local();
+    LOG_INFO("Game", "Behavior scripts: peak %zu frames in %zu arena chunks",
+             scriptFrames.getPeakCount(), scriptFrames.getChunkCount());
+    
+    for (std::size_t type = 0; type < PARTICLE_TYPE_COUNT; ++type) {
+        const ParticleType particleType = static_cast<ParticleType>(type);
+        const ParticleTypeStats& particles = particleSystem->getTypeStats(particleType);
+        LOG_INFO("Game", "Particles %s: %zu emitted, %zu evicted, %zu rejected",
+                 ParticleSystem::getTypeName(particleType), particles.emitted, particles.evicted, particles.rejected);
     }
 }
 
-void Game::handleEvents() {
-    sf::Event event;
-    while (window.pollEvent(event)) {
-        if (event.type == sf::Event::Closed) {
-            window.close();
+void Game::publishSnapshot() {
+    RenderSnapshot& snapshot = snapshots.getWriteBuffer();
+    snapshot.clear();
+    snapshot.tick = simulationTicks;
+    snapshot.state = currentState;
+    snapshot.cameraCenter = gameView.getCenter();
+    
+    if (currentState != GameState::Menu) {
+        snapshot.hud.score = score;
+        snapshot.hud.level = level;
+        snapshot.hud.health = superman->getHealth();
+        
+        superman->writeSnapshot(snapshot.superman);
+        
+        snapshot.ghosts.resize(ghosts.size());
+        for (size_t i = 0; i < ghosts.size(); ++i) {
+            ghosts[i]->writeSnapshot(snapshot.ghosts[i]);
         }
         
-        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
-            if (currentState == GameState::Playing) {
-                pauseGame();
-            } else if (currentState == GameState::Paused) {
-                resumeGame();
-            }
+        snapshot.projectiles.resize(projectiles.size());
+        for (size_t i = 0; i < projectiles.size(); ++i) {
+            projectiles[i]->writeSnapshot(snapshot.projectiles[i], snapshot.trailPoints);
         }
         
-        switch (currentState) {
-            case GameState::Menu:
-                handleMenuInput(event);
-                break;
-            case GameState::Playing:
-                handlePlayingInput(event);
-                break;
-            case GameState::Paused:
-                handlePausedInput(event);
-                break;
-            case GameState::GameOver:
-                handleGameOverInput(event);
-                break;
+        bullets.writeSnapshot(snapshot.bullets);
+        
+        particleSystem->writeSnapshot(snapshot.particles);
+    }
+    
+    snapshots.publish();
+    
+    {
+        std::lock_guard<std::mutex> lock(redrawMutex);
+        redrawPending = true;
+    }
+    redrawSignal.notify_one();
+}
+
+void Game::renderLoop() {
+    window.setActive(true);
+    
+    while (renderRunning) {
+        // Redraws the previous snapshot when the simulation has not published a new one,
+        // except in static states, where the picture on screen is still current
+        const bool fresh = snapshots.acquire();
+        if (!fresh && isStaticState(snapshots.getReadBuffer().state) && !background.isStreaming()) {
+            waitForRedraw();
+            continue;
+        }
+        
+        render(snapshots.getReadBuffer());
+        ++renderedFrames;
+        
+        if (renderedFrames % 600 == 0) {
+            const RenderQueueStats& frame = renderQueue.getFrameStats();
+            const CullStats& culling = culler.getFrameStats();
+            LOG_DEBUG("Game", "Render queue: %zu commands, %zu batches, %zu draw calls, %zu vertices",
+                      frame.submitted, frame.batches, frame.drawCalls, frame.vertices);
+            LOG_DEBUG("Game", "Culling: %zu drawn, %zu culled", culling.drawn, culling.culled);
+            const QualityStats& qualityStats = quality.getStats();
+            LOG_DEBUG("Game", "Quality %s: frame p50 %.2f ms, p95 %.2f ms",
+                      AdaptiveQuality::getSettings(qualityStats.level).name,
+                      qualityStats.p50Milliseconds, qualityStats.p95Milliseconds);
+        }
+    }
+    
+    window.setActive(false);
+}
+
+void Game::waitForRedraw() {
+    std::unique_lock<std::mutex> lock(redrawMutex);
+    redrawSignal.wait_for(lock, std::chrono::duration<float>(STATIC_WAIT_SECONDS), [this] {
+        return redrawPending || !renderRunning;
+    });
+    redrawPending = false;
+}
+
+void Game::handleEvents() {
+    sf::Event event;
+    while (window.pollEvent(event)) {
+        handleEvent(event);
+    }
+}
+
+bool Game::waitForEvents(sf::Time timeout) {
+    // SFML 2.5's waitEvent cannot time out, so poll at a low rate instead of blocking for good
+    sf::Clock waitClock;
+    sf::Event event;
+    while (!window.pollEvent(event)) {
+        if (waitClock.getElapsedTime() >= timeout) {
+            return false;
         }
+        sf::sleep(sf::seconds(EVENT_POLL_SECONDS));
+    }
+    
+    // The window contents may need repainting after a resize or when it comes back to the front
+    bool redraw = false;
+    do {
+        redraw = redraw || event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus;
+        handleEvent(event);
+    } while (window.pollEvent(event));
+    return redraw;
+}
+
+void Game::handleEvent(sf::Event& event) {
+    if (event.type == sf::Event::Closed) {
+        quitRequested = true;
+    }
+    
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+        if (currentState == GameState::Playing) {
+            pauseGame();
+        } else if (currentState == GameState::Paused) {
+            resumeGame();
+        }
+    }
+    
+    switch (currentState) {
+        case GameState::Menu:
+            handleMenuInput(event);
+            break;
+        case GameState::Playing:
+            handlePlayingInput(event);
+            break;
+        case GameState::Paused:
+            handlePausedInput(event);
+            break;
+        case GameState::GameOver:
+            handleGameOverInput(event);
+            break;
     }
 }
 
+bool Game::isStaticState(GameState state) {
+    return state == GameState::Menu || state == GameState::Paused || state == GameState::GameOver;
+}
+
 void Game::update(float deltaTime) {
     switch (currentState) {
         case GameState::Menu:
@@ -176,41 +394,100 @@ void Game::update(float deltaTime) {
     }
 }
 
-void Game::render() {
+void Game::render(const RenderSnapshot& snapshot) {
+    sf::Clock frameClock;
+    
+    // The scene behind the pause and game over screens cannot change, so it is
+    // drawn once into a texture and reused until the state changes
+    const bool frozen = snapshot.state == GameState::Paused || snapshot.state == GameState::GameOver;
+    if (!frozen) {
+        frozenSceneValid = false;
+    } else if (!frozenSceneValid) {
+        const sf::Vector2u size = window.getSize();
+        if (frozenScene.getSize() != size) {
+            frozenScene.create(size.x, size.y);
+        }
+        frozenScene.clear(sf::Color::Black);
+        hudRefreshDue = true; // The captured HUD must be current
+        submitScene(snapshot);
+        renderQueue.flush(frozenScene);
+        frozenScene.display();
+        // Capture again next time if background chunks were still arriving
+        frozenSceneValid = !background.isStreaming();
+    }
+    
     window.clear(sf::Color::Black);
     
-    // Draw background
-    if (backgroundSprite.getTexture()) {
-        window.draw(backgroundSprite);
+    if (frozen) {
+        sf::Sprite scene(frozenScene.getTexture());
+        scene.setScale(static_cast<float>(WINDOW_WIDTH) / frozenScene.getSize().x,
+                       static_cast<float>(WINDOW_HEIGHT) / frozenScene.getSize().y);
+        renderQueue.setView(RenderLayer::Sky, window.getDefaultView());
+        renderQueue.submit(RenderLayer::Background, scene);
+    } else {
+        submitScene(snapshot);
     }
     
-    switch (currentState) {
+    switch (snapshot.state) {
         case GameState::Menu:
             renderMenu();
             break;
         case GameState::Playing:
-            renderPlaying();
             break;
         case GameState::Paused:
-            renderPlaying(); // Show game behind pause menu
             renderPaused();
             break;
         case GameState::GameOver:
-            renderPlaying(); // Show game behind game over screen
             renderGameOver();
             break;
     }
     
+    renderQueue.flush(window);
+    
+    // Only gameplay frames count; static screens draw rarely and capture the scene once
+    if (snapshot.state == GameState::Playing) {
+        quality.addFrameTime(frameClock.getElapsedTime().asSeconds());
+    }
+    
     window.display();
 }
 
+void Game::submitScene(const RenderSnapshot& snapshot) {
+    // World layers follow the camera; parallax layers, HUD and overlays stay in window coordinates
+    sf::View worldView(snapshot.cameraCenter, sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
+    renderQueue.setView(RenderLayer::Sky, window.getDefaultView());
+    renderQueue.setView(RenderLayer::Background, worldView);
+    renderQueue.setView(RenderLayer::Hud, window.getDefaultView());
+    
+    // Circle detail follows the on-screen size, reduced at lower quality
+    const QualitySettings& settings = quality.getSettings();
+    renderQueue.setPixelScale(window.getSize().x / worldView.getSize().x * settings.circleDetail);
+    culler.setView(worldView);
+    culler.resetStats();
+    
+    // Draw the parallax layers, then the near city chunks around the camera
+    parallax.submit(renderQueue, snapshot.cameraCenter, sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
+    background.update(culler.getViewBounds());
+    background.submit(renderQueue, culler.getViewBounds());
+    
+    if (snapshot.state != GameState::Menu) {
+        renderPlaying(snapshot);
+    }
+}
+
 void Game::updateMenu(float deltaTime) {
     // Menu doesn't need updates, just wait for input
 }
 
 void Game::updatePlaying(float deltaTime) {
+    applyQualitySettings();
+    
+    // Fire the gameplay timers that fall due this tick
+    timers.advance(deltaTime);
+    
     // Update Superman
-    superman->update(deltaTime, window);
+    superman->update(deltaTime, getWorldBounds());
+    updateCamera(deltaTime);
     
     // Update ghosts
     for (auto& ghost : ghosts) {
@@ -220,13 +497,16 @@ void Game::updatePlaying(float deltaTime) {
     // Update projectiles
     for (auto it = projectiles.begin(); it != projectiles.end();) {
         (*it)->update(deltaTime);
-        if (!(*it)->isActive() || (*it)->isOffScreen(WINDOW_WIDTH, WINDOW_HEIGHT)) {
+        if (!(*it)->isActive() || (*it)->isOutside(getWorldBounds())) {
             it = projectiles.erase(it);
         } else {
             ++it;
         }
     }
     
+    // Update boss bullets (after the timers, so this tick's volleys are in the collision grid)
+    bullets.update(deltaTime);
+    
     // Update particle system
     particleSystem->update(deltaTime);
     
@@ -243,8 +523,9 @@ void Game::updatePlaying(float deltaTime) {
         gameOver();
     }
     
-    // Health regeneration
-    superman->regenerateHealth(deltaTime);
+    // Emit every effect this tick asked for (input included) in one pass
+    particleSystem->emitBatch(effectRequests);
+    effectRequests.clear();
 }
 
 void Game::updatePaused(float deltaTime) {
@@ -256,63 +537,89 @@ void Game::updateGameOver(float deltaTime) {
 }
 
 void Game::renderMenu() {
-    window.draw(titleText);
-    window.draw(instructionText);
+    renderQueue.submitDrawable(RenderLayer::Hud, titleText);
+    renderQueue.submitDrawable(RenderLayer::Hud, instructionText);
 }
 
-void Game::renderPlaying() {
+void Game::renderPlaying(const RenderSnapshot& snapshot) {
+    // Each group is culled against the view before it generates any geometry
+    
     // Draw Superman
-    superman->render(window);
+    culler.clear();
+    culler.add(Superman::getRenderBounds(snapshot.superman));
+    if (!culler.cull().empty()) {
+        Superman::render(snapshot.superman, renderQueue);
+    }
     
     // Draw ghosts
-    for (const auto& ghost : ghosts) {
-        ghost->render(window);
+    culler.clear();
+    for (const auto& ghost : snapshot.ghosts) {
+        culler.add(Ghost::getRenderBounds(ghost));
+    }
+    for (std::uint32_t index : culler.cull()) {
+        Ghost::render(snapshot.ghosts[index], renderQueue, quality.getSettings().ghostTailSegments);
     }
     
     // Draw projectiles
-    for (const auto& projectile : projectiles) {
-        projectile->render(window);
+    culler.clear();
+    for (const auto& projectile : snapshot.projectiles) {
+        culler.add(Projectile::getRenderBounds(projectile, snapshot.trailPoints.data()));
+    }
+    for (std::uint32_t index : culler.cull()) {
+        Projectile::render(snapshot.projectiles[index], snapshot.trailPoints.data(), renderQueue);
+    }
+    
+    // Draw boss bullets, all in one batch
+    culler.clear();
+    for (const auto& bullet : snapshot.bullets) {
+        culler.add(BulletEngine::getRenderBounds(bullet));
     }
+    BulletEngine::render(snapshot.bullets, culler.cull(), bulletVertices, renderQueue);
     
     // Draw particles
-    particleSystem->render(window);
+    culler.clear();
+    for (const auto& particle : snapshot.particles) {
+        culler.add(ParticleSystem::getRenderBounds(particle));
+    }
+    ParticleSystem::render(snapshot.particles, culler.cull(), renderQueue);
     
     // Draw UI
-    renderUI();
+    renderUI(snapshot.hud);
 }
 
 void Game::renderPaused() {
     // Draw semi-transparent overlay
-    sf::RectangleShape overlay(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
-    overlay.setFillColor(sf::Color(0, 0, 0, 128));
-    window.draw(overlay);
+    renderQueue.submit(RenderLayer::Overlay, dimOverlay);
     
-    window.draw(pausedText);
+    renderQueue.submitDrawable(RenderLayer::OverlayText, pausedText);
 }
 
 void Game::renderGameOver() {
     // Draw semi-transparent overlay
-    sf::RectangleShape overlay(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
-    overlay.setFillColor(sf::Color(0, 0, 0, 128));
-    window.draw(overlay);
+    renderQueue.submit(RenderLayer::Overlay, dimOverlay);
     
-    window.draw(gameOverText);
+    renderQueue.submitDrawable(RenderLayer::OverlayText, gameOverText);
 }
 
-void Game::renderUI() {
-    scoreText.setString("Score: " + std::to_string(score));
-    levelText.setString("Level: " + std::to_string(level));
-    healthText.setString("Health: " + std::to_string(static_cast<int>(superman->getHealth())) + "/100");
+void Game::renderUI(const HudSnapshot& hud) {
+    // Rebuilding text geometry is the expensive part of the HUD, so it is rate limited at lower quality
+    if (hudRefreshDue || hudRefreshClock.getElapsedTime().asSeconds() >= quality.getSettings().hudRefreshSeconds) {
+        scoreText.setString("Score: " + std::to_string(hud.score));
+        levelText.setString("Level: " + std::to_string(hud.level));
+        healthText.setString("Health: " + std::to_string(static_cast<int>(hud.health)) + "/100");
+        hudRefreshClock.restart();
+        hudRefreshDue = false;
+    }
     
-    window.draw(scoreText);
-    window.draw(levelText);
-    window.draw(healthText);
+    renderQueue.submitDrawable(RenderLayer::Hud, scoreText);
+    renderQueue.submitDrawable(RenderLayer::Hud, levelText);
+    renderQueue.submitDrawable(RenderLayer::Hud, healthText);
     
-    renderHealthBar();
+    renderHealthBar(hud);
 }
 
-void Game::renderHealthBar() {
-    float healthPercent = superman->getHealth() / 100.0f;
+void Game::renderHealthBar(const HudSnapshot& hud) {
+    float healthPercent = hud.health / 100.0f;
     
     // Background bar
     sf::RectangleShape healthBarBg(sf::Vector2f(200, 20));
@@ -326,8 +633,8 @@ void Game::renderHealthBar() {
     healthBar.setPosition(WINDOW_WIDTH - 220, 10);
     healthBar.setFillColor(sf::Color::Green);
     
-    window.draw(healthBarBg);
-    window.draw(healthBar);
+    renderQueue.submit(RenderLayer::Hud, healthBarBg);
+    renderQueue.submit(RenderLayer::Hud, healthBar);
 }
 
 void Game::handleMenuInput(sf::Event& event) {
@@ -339,37 +646,39 @@ void Game::handleMenuInput(sf::Event& event) {
 void Game::handlePlayingInput(sf::Event& event) {
     if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Space) {
         // Fire laser
-        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+        sf::Vector2f mousePos = mapPixelToWorld(sf::Mouse::getPosition(window));
         auto laser = std::make_unique<Projectile>(
             superman->getPosition(), 
-            sf::Vector2f(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y)),
-            ProjectileType::Laser
+            mousePos,
+            ProjectileType::Laser,
+            timers
         );
+        laser->setMaxTrailPoints(quality.getSettings().maxTrailPoints);
         projectiles.push_back(std::move(laser));
         
-        laserSound.play();
+        audio.playEffect(SoundEvent::Laser);
         
         // Add laser particles
-        particleSystem->addLaserEffect(superman->getPosition());
+        effectRequests.push_back(EffectRequest{ superman->getPosition(), ParticleType::Laser });
     }
     
     if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
         // Super punch
-        sf::Vector2f mousePos(static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y));
+        sf::Vector2f mousePos = mapPixelToWorld(sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
         superman->performPunch(mousePos);
         
-        punchSound.play();
+        audio.playEffect(SoundEvent::Punch);
         
         // Check punch collision with ghosts
         for (auto it = ghosts.begin(); it != ghosts.end();) {
             if (superman->isPunching() && superman->getPunchRange().intersects((*it)->getBounds())) {
                 // Add explosion effect
-                particleSystem->addExplosion((*it)->getPosition());
+                effectRequests.push_back(EffectRequest{ (*it)->getPosition(), ParticleType::Explosion });
                 
                 // Add score based on ghost type
                 score += (*it)->getScoreValue();
                 
-                ghostDeathSound.play();
+                audio.playEffect(SoundEvent::GhostDeath);
                 
                 it = ghosts.erase(it);
             } else {
@@ -378,7 +687,7 @@ void Game::handlePlayingInput(sf::Event& event) {
         }
         
         // Add punch particles
-        particleSystem->addPunchEffect(mousePos);
+        effectRequests.push_back(EffectRequest{ mousePos, ParticleType::Punch });
     }
 }
 
@@ -398,23 +707,26 @@ void Game::startGame() {
     currentState = GameState::Playing;
     score = 0;
     level = 1;
-    superman->reset(WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f);
+    superman->reset(WORLD_WIDTH / 2.0f, WORLD_HEIGHT / 2.0f);
+    snapCamera();
     ghosts.clear();
     projectiles.clear();
+    bullets.clear();
     particleSystem->clear();
+    effectRequests.clear();
     spawnGhosts();
     
-    backgroundMusic.play();
+    audio.playMusic();
 }
 
 void Game::pauseGame() {
     currentState = GameState::Paused;
-    backgroundMusic.pause();
+    audio.pauseMusic();
 }
 
 void Game::resumeGame() {
     currentState = GameState::Playing;
-    backgroundMusic.play();
+    audio.playMusic();
 }
 
 void Game::restartGame() {
@@ -423,7 +735,7 @@ void Game::restartGame() {
 
 void Game::gameOver() {
     currentState = GameState::GameOver;
-    backgroundMusic.stop();
+    audio.stopMusic();
 }
 
 void Game::nextLevel() {
@@ -431,7 +743,7 @@ void Game::nextLevel() {
     spawnGhosts();
     
     // Add level completion particles
-    particleSystem->addLevelCompleteEffect(sf::Vector2f(WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2));
+    effectRequests.push_back(EffectRequest{ superman->getPosition(), ParticleType::LevelComplete });
 }
 
 void Game::spawnGhosts() {
@@ -441,8 +753,12 @@ void Game::spawnGhosts() {
     
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> xDist(50, WINDOW_WIDTH - 50);
-    std::uniform_real_distribution<float> yDist(50, WINDOW_HEIGHT - 50);
+    // Spawn in a window-sized area around Superman, kept inside the world
+    sf::Vector2f supermanPosition = superman->getPosition();
+    float areaLeft = std::max(0.0f, std::min(supermanPosition.x - WINDOW_WIDTH / 2.0f, static_cast<float>(WORLD_WIDTH - WINDOW_WIDTH)));
+    float areaTop = std::max(0.0f, std::min(supermanPosition.y - WINDOW_HEIGHT / 2.0f, static_cast<float>(WORLD_HEIGHT - WINDOW_HEIGHT)));
+    std::uniform_real_distribution<float> xDist(areaLeft + 50, areaLeft + WINDOW_WIDTH - 50);
+    std::uniform_real_distribution<float> yDist(areaTop + 50, areaTop + WINDOW_HEIGHT - 50);
     std::uniform_real_distribution<float> typeDist(0.0f, 1.0f);
     
     for (int i = 0; i < ghostCount; ++i) {
@@ -454,23 +770,91 @@ void Game::spawnGhosts() {
         } while (std::abs(x - superman->getPosition().x) < 100 && 
                  std::abs(y - superman->getPosition().y) < 100);
         
-        // Determine ghost type
-        GhostType type = GhostType::Regular;
+        // Determine ghost type: the level's boss last, weighted picks for the rest
+        const GhostTypeDef* type = i == ghostCount - 1 ? ghostTypes.findBossFor(level) : nullptr;
         float typeRoll = typeDist(gen);
+        if (!type) {
+            type = &ghostTypes.pickByWeight(typeRoll);
+        }
+        
+        ghosts.push_back(std::make_unique<Ghost>(sf::Vector2f(x, y), *type, bullets, scripts));
+    }
+}
+
+void Game::updateGhostAi() {
+    // Each type's program runs once over all of its ghosts, gathered into lanes
+    for (std::size_t id = 0; id < ghostTypes.getCount(); ++id) {
+        const GhostTypeDef& type = ghostTypes.get(id);
+        if (type.ai.isEmpty()) {
+            continue;
+        }
         
-        if (level % 3 == 0 && i == ghostCount - 1) {
-            type = GhostType::Boss; // Boss ghost every 3rd level
-        } else if (typeRoll < 0.3f) {
-            type = GhostType::Fast;
+        ghostLanes.clear();
+        for (const auto& ghost : ghosts) {
+            if (&ghost->getType() == &type) {
+                ghost->writeLane(ghostLanes);
+            }
         }
+        if (ghostLanes.size() == 0) {
+            continue;
+        }
+        
+        ghostVM.execute(type.ai, ghostLanes);
         
-        ghosts.push_back(std::make_unique<Ghost>(sf::Vector2f(x, y), type));
+        std::size_t lane = 0;
+        for (const auto& ghost : ghosts) {
+            if (&ghost->getType() == &type) {
+                ghost->readLane(ghostLanes, lane++);
+            }
+        }
+    }
+}
+
+void Game::applyQualitySettings() {
+    const int level = quality.getLevel();
+    if (level == appliedQualityLevel) {
+        return;
+    }
+    
+    const QualitySettings& settings = AdaptiveQuality::getSettings(level);
+    particleSystem->setMaxParticles(settings.maxParticles);
+    particleSystem->setEmissionScale(settings.particleScale);
+    for (auto& projectile : projectiles) {
+        projectile->setMaxTrailPoints(settings.maxTrailPoints);
     }
+    appliedQualityLevel = level;
+}
+
+sf::FloatRect Game::getWorldBounds() const {
+    return sf::FloatRect(0, 0, WORLD_WIDTH, WORLD_HEIGHT);
+}
+
+sf::Vector2f Game::mapPixelToWorld(sf::Vector2i pixel) const {
+    // Uses the simulation's camera, not whatever view the render thread last set
+    return window.mapPixelToCoords(pixel, gameView);
+}
+
+void Game::updateCamera(float deltaTime) {
+    // Ease towards Superman, frame-rate independent
+    sf::Vector2f center = gameView.getCenter();
+    float blend = 1.0f - std::exp(-CAMERA_FOLLOW_RATE * deltaTime);
+    center += (superman->getPosition() - center) * blend;
+    
+    // Never show anything outside the world
+    sf::Vector2f halfSize = gameView.getSize() / 2.0f;
+    center.x = std::max(halfSize.x, std::min(WORLD_WIDTH - halfSize.x, center.x));
+    center.y = std::max(halfSize.y, std::min(WORLD_HEIGHT - halfSize.y, center.y));
+    gameView.setCenter(center);
+}
+
+void Game::snapCamera() {
+    gameView.setCenter(superman->getPosition());
+    updateCamera(0.0f);
 }
 
 void Game::checkCollisions() {
     checkProjectileCollisions();
-    checkSupermanGhostCollisions();
+    checkBulletCollisions();
 }
 
 void Game::checkProjectileCollisions() {
@@ -480,10 +864,10 @@ void Game::checkProjectileCollisions() {
         for (auto ghostIt = ghosts.begin(); ghostIt != ghosts.end();) {
             if ((*projIt)->getBounds().intersects((*ghostIt)->getBounds())) {
                 // Projectile hit ghost
-                particleSystem->addExplosion((*ghostIt)->getPosition());
+                effectRequests.push_back(EffectRequest{ (*ghostIt)->getPosition(), ParticleType::Explosion });
                 
                 score += (*ghostIt)->getScoreValue();
-                ghostDeathSound.play();
+                audio.playEffect(SoundEvent::GhostDeath);
                 
                 ghostIt = ghosts.erase(ghostIt);
                 projDestroyed = true;
@@ -501,6 +885,19 @@ void Game::checkProjectileCollisions() {
     }
 }
 
+void Game::checkBulletCollisions() {
+    // A punch knocks away the bullets in its reach
+    if (superman->isPunching() && bullets.collide(superman->getPunchRange()) > 0) {
+        effectRequests.push_back(EffectRequest{ superman->getPosition(), ParticleType::Spark });
+    }
+    
+    const std::size_t hits = bullets.collide(superman->getBounds());
+    if (hits > 0) {
+        superman->takeDamage(hits * BulletEngine::getDamage());
+        effectRequests.push_back(EffectRequest{ superman->getPosition(), ParticleType::Damage });
+    }
+}
+
 void Game::checkSupermanGhostCollisions() {
     sf::FloatRect supermanBounds = superman->getBounds();
     
@@ -509,7 +906,7 @@ void Game::checkSupermanGhostCollisions() {
             superman->takeDamage(ghost->getDamage());
             
             // Add damage effect
-            particleSystem->addDamageEffect(superman->getPosition());
+            effectRequests.push_back(EffectRequest{ superman->getPosition(), ParticleType::Damage });
         }
     }
 }
\ No newline at end of file
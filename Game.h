@@ -4,18 +4,27 @@
 #include <SFML/Audio.hpp>
 #include <vector>
 #include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include "Superman.h"
 #include "Ghost.h"
 #include "Projectile.h"
+#include "BulletEngine.h"
+#include "BehaviorScript.h"
+#include "GhostTypes.h"
+#include "GhostVM.h"
 #include "ParticleSystem.h"
 #include "ResourceManager.h"
-
-enum class GameState {
-    Menu,
-    Playing,
-    Paused,
-    GameOver
-};
+#include "AudioThread.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "BackgroundStreamer.h"
+#include "ParallaxBackground.h"
+#include "AdaptiveQuality.h"
 
 class Game {
 public:
@@ -28,8 +37,21 @@ public:
 private:
     // Core systems
     void handleEvents();
+    void handleEvent(sf::Event& event);
+    bool waitForEvents(sf::Time timeout);
     void update(float deltaTime);
-    void render();
+    
+    // Render thread: the simulation publishes a snapshot after every tick and
+    // the render thread draws the newest one it can get
+    void publishSnapshot();
+    void renderLoop();
+    void waitForRedraw();
+    void render(const RenderSnapshot& snapshot);
+    void submitScene(const RenderSnapshot& snapshot);
+    
+    // Menu, Paused and GameOver show a still picture: they are redrawn only
+    // when something changes instead of every tick
+    static bool isStaticState(GameState state);
     
     // Game state management
     void updateMenu(float deltaTime);
@@ -38,7 +60,7 @@ private:
     void updateGameOver(float deltaTime);
     
     void renderMenu();
-    void renderPlaying();
+    void renderPlaying(const RenderSnapshot& snapshot);
     void renderPaused();
     void renderGameOver();
     
@@ -50,6 +72,14 @@ private:
     void gameOver();
     void nextLevel();
     void spawnGhosts();
+    void updateGhostAi();
+    void applyQualitySettings();
+    
+    // World and camera
+    sf::FloatRect getWorldBounds() const;
+    sf::Vector2f mapPixelToWorld(sf::Vector2i pixel) const;
+    void updateCamera(float deltaTime);
+    void snapCamera();
     
     // Input handling
     void handleMenuInput(sf::Event& event);
@@ -60,17 +90,18 @@ private:
     // Collision detection
     void checkCollisions();
     void checkProjectileCollisions();
+    void checkBulletCollisions();
     void checkSupermanGhostCollisions();
     
     // UI rendering
-    void renderUI();
-    void renderHealthBar();
+    void renderUI(const HudSnapshot& hud);
+    void renderHealthBar(const HudSnapshot& hud);
     void renderScore();
     void renderLevel();
     
     // Window and graphics
     sf::RenderWindow window;
-    sf::View gameView;
+    sf::View gameView; // Camera following Superman; simulation thread only
     sf::Clock clock;
     
     // Game state
@@ -79,14 +110,26 @@ private:
     int level;
     bool isMousePressed;
     
-    // Game objects
+    // Game objects (the timing wheel first, so it outlives everything holding timers in it)
+    TimingWheel timers; // Simulation ticks; only advances while playing
+    BulletEngine bullets; // Boss barrages; ghosts fire into it
+    ScriptScheduler scripts; // Resumes boss behavior scripts off the timing wheel
+    GhostTypeCatalog ghostTypes; // Before the ghosts, which refer to their types
     std::unique_ptr<Superman> superman;
     std::vector<std::unique_ptr<Ghost>> ghosts;
+    GhostVM ghostVM;
+    GhostLanes ghostLanes; // One type's ghosts at a time
+    TimerHandle ghostAiTimer;
+    TimerHandle contactDamageTimer;
     std::vector<std::unique_ptr<Projectile>> projectiles;
     std::unique_ptr<ParticleSystem> particleSystem;
+    std::vector<EffectRequest> effectRequests; // Collected during a tick, emitted as one batch
     
-    // Resources
+    // Resources (references keep what the game uses resident under the memory budget)
     ResourceManager resourceManager;
+    SoundBufferRef laserBuffer;
+    SoundBufferRef punchBuffer;
+    SoundBufferRef ghostDeathBuffer;
     
     // UI elements
     sf::Font font;
@@ -97,18 +140,54 @@ private:
     sf::Text instructionText;
     sf::Text gameOverText;
     sf::Text pausedText;
-    
-    // Background
-    sf::Sprite backgroundSprite;
+    sf::RectangleShape dimOverlay;
+    
+    // Background (render thread only): parallax sky layers behind the streamed near city
+    ParallaxBackground parallax;
+    BackgroundStreamer background;
+    
+    // Threading (UI elements and background are only touched by the render thread once it starts)
+    TripleBuffer<RenderSnapshot> snapshots;
+    std::thread renderThread;
+    std::atomic<bool> renderRunning;
+    bool quitRequested;
+    std::uint64_t simulationTicks;
+    std::uint64_t renderedFrames;
+    RenderQueue renderQueue; // Render thread only
+    std::vector<sf::Vertex> bulletVertices; // Render thread only
+    FrustumCuller culler;    // Render thread only
+    
+    // Redraw on demand in static states: the render thread sleeps until a new snapshot is published
+    std::mutex redrawMutex;
+    std::condition_variable redrawSignal;
+    bool redrawPending;
+    
+    // Last playing frame, captured once when entering Paused or GameOver (render thread only)
+    sf::RenderTexture frozenScene;
+    bool frozenSceneValid;
+    
+    // Quality level follows the render thread's frame times; the simulation applies its share each tick
+    AdaptiveQuality quality;
+    int appliedQualityLevel; // Simulation thread only
+    sf::Clock hudRefreshClock; // Render thread only
+    bool hudRefreshDue;        // Render thread only
     
     // Audio
+    // Owned by the audio thread once it starts; the game only posts commands
     sf::Music backgroundMusic;
-    sf::Sound laserSound;
-    sf::Sound punchSound;
-    sf::Sound ghostDeathSound;
+    AudioVoicePool soundEffects;
+    AudioThread audio; // Declared last so it stops before the objects it uses go away
     
     // Constants
     static const int WINDOW_WIDTH = 800;
     static const int WINDOW_HEIGHT = 600;
+    static const int WORLD_WIDTH = 3072;
+    static const int WORLD_HEIGHT = 2304;
+    static const float CAMERA_FOLLOW_RATE;
     static const float TARGET_FPS;
+    static const float SIMULATION_RATE;
+    static const float CONTACT_DAMAGE_INTERVAL;
+    static const float STATIC_WAIT_SECONDS;
+    static const float EVENT_POLL_SECONDS;
+    static const float FRAME_BUDGET_SECONDS;
 };
\ No newline at end of file
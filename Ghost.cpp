@@ -1,11 +1,42 @@
 #include "Ghost.h"
+#include "RenderSnapshot.h"
+#include "RenderQueue.h"
 #include <cmath>
+#include <iterator>
 #include <random>
 
 const float Ghost::BASE_SIZE = 30.0f;
 const float Ghost::COLLISION_RADIUS = 25.0f;
+const float Ghost::AI_INTERVAL = 0.1f; // AI updates 10 times per second
 
-Ghost::Ghost(sf::Vector2f startPosition, GhostType ghostType)
+namespace {
+
+// Boss barrages, taken in turn, one per attack
+struct BossBarrage {
+    BulletPattern pattern;
+    int volleys;
+    float interval; // Seconds between volleys
+    int count;      // Bullets (spiral arms) per volley
+    float speed;
+    float spread;   // Aimed spreads
+    float turn;     // Radians the ring angle moves on by after each volley
+    float curl;     // Spirals
+};
+
+const BossBarrage BOSS_BARRAGES[] = {
+    { BulletPattern::Ring,         3, 0.25f, 24, 160.0f, 0.0f, 0.13f, 0.0f },
+    { BulletPattern::Spiral,      30, 0.05f,  4, 180.0f, 0.0f, 0.25f, 0.6f },
+    { BulletPattern::AimedSpread,  4, 0.15f,  7, 240.0f, 0.8f, 0.0f,  0.0f }
+};
+
+const float BOSS_ATTACK_SECONDS = 3.0f; // From the start of one attack to the next
+const float BOSS_ORBIT_ANGLE = 2.0f / 60.0f; // Radians off a straight chase (2 rad/s over a 60 FPS frame)
+const float BOSS_JITTER = 0.3f;
+
+}
+
+Ghost::Ghost(sf::Vector2f startPosition, const GhostTypeDef& ghostType, BulletEngine& bullets,
+             ScriptScheduler& scripts)
     : position(startPosition)
     , velocity(0, 0)
     , basePosition(startPosition)
@@ -16,10 +47,8 @@ Ghost::Ghost(sf::Vector2f startPosition, GhostType ghostType)
     , animationTimer(0.0f)
     , currentFrame(0)
     , transparency(0.8f)
-    , aiUpdateTimer(0.0f)
-    , damageTimer(0.0f)
-    , bossAttackTimer(0.0f)
-    , bossAttackCooldown(3.0f) {
+    , targetPosition(startPosition)
+    , bullets(bullets) {
     
     // Initialize random floating offset
     std::random_device rd;
@@ -28,56 +57,29 @@ Ghost::Ghost(sf::Vector2f startPosition, GhostType ghostType)
     floatingTimer = dist(gen);
     
     initializeByType();
+    
+    // Bosses follow their scripts; other ghosts are moved by their type's AI program
+    if (type.isBoss()) {
+        bossMovement = runBossMovement(scripts, *this);
+        bossAttacks = runBossAttacks(scripts, *this);
+    }
 }
 
-Ghost::~Ghost() = default;
-
 void Ghost::initializeByType() {
-    switch (type) {
-        case GhostType::Regular:
-            health = 20.0f;
-            maxHealth = 20.0f;
-            speed = 80.0f;
-            aggroRange = 200.0f;
-            damageValue = 10.0f;
-            size = BASE_SIZE;
-            ghostColor = sf::Color(255, 255, 255, static_cast<sf::Uint8>(255 * transparency));
-            break;
-            
-        case GhostType::Fast:
-            health = 15.0f;
-            maxHealth = 15.0f;
-            speed = 150.0f;
-            aggroRange = 250.0f;
-            damageValue = 15.0f;
-            size = BASE_SIZE * 0.8f;
-            ghostColor = sf::Color(200, 200, 255, static_cast<sf::Uint8>(255 * transparency));
-            floatingFrequency = 4.0f; // Faster floating
-            break;
-            
-        case GhostType::Boss:
-            health = 50.0f;
-            maxHealth = 50.0f;
-            speed = 60.0f;
-            aggroRange = 300.0f;
-            damageValue = 20.0f;
-            size = BASE_SIZE * 1.5f;
-            ghostColor = sf::Color(255, 200, 200, static_cast<sf::Uint8>(255 * transparency));
-            floatingAmplitude = 15.0f; // Bigger floating motion
-            break;
-    }
+    health = type.health;
+    maxHealth = type.health;
+    speed = type.speed;
+    aggroRange = type.aggroRange;
+    damageValue = type.damage;
+    size = BASE_SIZE * type.sizeScale;
+    ghostColor = sf::Color(type.color.r, type.color.g, type.color.b, static_cast<sf::Uint8>(255 * transparency));
+    floatingAmplitude = type.floatingAmplitude;
+    floatingFrequency = type.floatingFrequency;
 }
 
 void Ghost::update(float deltaTime, sf::Vector2f supermanPosition) {
-    // Update timers
-    aiUpdateTimer += deltaTime;
-    damageTimer += deltaTime;
-    
-    // AI behavior
-    if (aiUpdateTimer >= 0.1f) { // Update AI 10 times per second
-        moveTowardsSuperman(supermanPosition, deltaTime);
-        aiUpdateTimer = 0.0f;
-    }
+    // AI batches and boss scripts run from the timing wheel
+    targetPosition = supermanPosition;
     
     // Apply velocity
     position += velocity * deltaTime;
@@ -87,75 +89,59 @@ void Ghost::update(float deltaTime, sf::Vector2f supermanPosition) {
     
     // Update general animation
     updateAnimation(deltaTime);
-    
-    // Boss specific updates
-    if (type == GhostType::Boss) {
-        updateBossAttack(deltaTime, supermanPosition);
-    }
 }
 
-void Ghost::render(sf::RenderWindow& window) {
+void Ghost::writeSnapshot(GhostSnapshot& snapshot) const {
+    snapshot.position = position;
+    snapshot.color = ghostColor;
+    snapshot.size = size;
+    snapshot.animationTimer = animationTimer;
+    snapshot.healthFraction = health / maxHealth;
+    snapshot.boss = type.isBoss();
+}
+
+void Ghost::render(const GhostSnapshot& snapshot, RenderQueue& queue, int tailSegments) {
     // Draw ghost body
-    drawGhostBody(window);
+    drawGhostBody(snapshot, queue, tailSegments);
     
     // Draw ghost face
-    drawGhostFace(window);
+    drawGhostFace(snapshot, queue);
     
     // Draw boss effects
-    if (type == GhostType::Boss) {
-        drawBossEffects(window);
+    if (snapshot.boss) {
+        drawBossEffects(snapshot, queue);
     }
     
     // Draw health bar for boss
-    if (type == GhostType::Boss) {
-        float healthPercent = health / maxHealth;
+    if (snapshot.boss) {
+        const sf::Vector2f& position = snapshot.position;
+        const float size = snapshot.size;
         
         sf::RectangleShape healthBarBg(sf::Vector2f(size * 1.2f, 4));
         healthBarBg.setPosition(position.x - size * 0.6f, position.y - size * 0.8f);
         healthBarBg.setFillColor(sf::Color::Red);
         
-        sf::RectangleShape healthBar(sf::Vector2f(size * 1.2f * healthPercent, 4));
+        sf::RectangleShape healthBar(sf::Vector2f(size * 1.2f * snapshot.healthFraction, 4));
         healthBar.setPosition(position.x - size * 0.6f, position.y - size * 0.8f);
         healthBar.setFillColor(sf::Color::Green);
         
-        window.draw(healthBarBg);
-        window.draw(healthBar);
+        queue.submit(RenderLayer::Ghosts, healthBarBg);
+        queue.submit(RenderLayer::Ghosts, healthBar);
     }
 }
 
-void Ghost::moveTowardsSuperman(sf::Vector2f supermanPosition, float deltaTime) {
-    sf::Vector2f direction = supermanPosition - position;
-    float distance = std::sqrt(direction.x * direction.x + direction.y * direction.y);
-    
-    if (distance > 0 && distance <= aggroRange) {
-        // Normalize direction
-        direction.x /= distance;
-        direction.y /= distance;
-        
-        // Add some randomness to movement
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<float> randomness(-0.3f, 0.3f);
-        
-        direction.x += randomness(gen);
-        direction.y += randomness(gen);
-        
-        // Apply movement
-        velocity = direction * speed;
-        
-        // Boss ghosts have different movement patterns
-        if (type == GhostType::Boss) {
-            // Circular movement around Superman
-            float angle = std::atan2(direction.y, direction.x);
-            angle += deltaTime * 2.0f; // Orbit speed
-            
-            velocity.x = std::cos(angle) * speed;
-            velocity.y = std::sin(angle) * speed;
-        }
-    } else {
-        // Apply friction when not moving towards Superman
-        velocity *= 0.9f;
-    }
+sf::FloatRect Ghost::getRenderBounds(const GhostSnapshot& snapshot) {
+    // Boss aura is the widest part; the tail wave adds a few pixels below
+    const float extent = snapshot.size * 1.2f + 4.0f;
+    return sf::FloatRect(snapshot.position.x - extent, snapshot.position.y - extent, extent * 2, extent * 2);
+}
+
+void Ghost::writeLane(GhostLanes& lanes) const {
+    lanes.add(position, targetPosition, velocity, speed, aggroRange);
+}
+
+void Ghost::readLane(const GhostLanes& lanes, std::size_t lane) {
+    velocity = sf::Vector2f(lanes.velocityX[lane], lanes.velocityY[lane]);
 }
 
 void Ghost::avoidOtherGhosts(float deltaTime) {
@@ -178,8 +164,6 @@ void Ghost::takeDamage(float damage) {
     if (health < 0) {
         health = 0;
     }
-    
-    damageTimer = 0.0f; // Reset damage timer for visual feedback
 }
 
 sf::FloatRect Ghost::getBounds() const {
@@ -192,16 +176,7 @@ sf::FloatRect Ghost::getBounds() const {
 }
 
 int Ghost::getScoreValue() const {
-    switch (type) {
-        case GhostType::Regular:
-            return 10;
-        case GhostType::Fast:
-            return 20;
-        case GhostType::Boss:
-            return 50;
-        default:
-            return 10;
-    }
+    return type.score;
 }
 
 void Ghost::updateAnimation(float deltaTime) {
@@ -213,89 +188,111 @@ void Ghost::updateAnimation(float deltaTime) {
     // Update ghost color with new transparency
     sf::Uint8 alpha = static_cast<sf::Uint8>(255 * transparency);
     
-    switch (type) {
-        case GhostType::Regular:
-            ghostColor = sf::Color(255, 255, 255, alpha);
-            break;
-        case GhostType::Fast:
-            ghostColor = sf::Color(200, 200, 255, alpha);
-            break;
-        case GhostType::Boss:
-            ghostColor = sf::Color(255, 200, 200, alpha);
-            break;
-    }
+    ghostColor = sf::Color(type.color.r, type.color.g, type.color.b, alpha);
 }
 
-void Ghost::updateBossAttack(float deltaTime, sf::Vector2f supermanPosition) {
-    bossAttackTimer += deltaTime;
+BehaviorScript Ghost::runBossMovement(ScriptScheduler& scripts, Ghost& boss) {
+    // Chase Superman slightly off a straight line; rotating by a fixed angle
+    // needs no trig per step
+    const float orbitCos = std::cos(BOSS_ORBIT_ANGLE);
+    const float orbitSin = std::sin(BOSS_ORBIT_ANGLE);
+    std::mt19937 random(std::random_device{}());
+    std::uniform_real_distribution<float> jitter(-BOSS_JITTER, BOSS_JITTER);
     
-    if (bossAttackTimer >= bossAttackCooldown) {
-        // Boss special attack - could spawn projectiles or create area effects
-        bossAttackTimer = 0.0f;
-        
-        // For now, just increase damage temporarily
-        damageValue = 30.0f;
+    while (true) {
+        co_await scripts.wait(AI_INTERVAL);
         
-        // Reset damage after short time
-        if (damageTimer > 0.5f) {
-            damageValue = 20.0f;
+        sf::Vector2f direction = boss.targetPosition - boss.position;
+        float distance = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+        if (distance > 0 && distance <= boss.aggroRange) {
+            // Some randomness, as for the other ghosts
+            direction /= distance;
+            direction.x += jitter(random);
+            direction.y += jitter(random);
+            const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+            if (length > 0) {
+                direction /= length;
+            }
+            boss.velocity = sf::Vector2f(direction.x * orbitCos - direction.y * orbitSin,
+                                         direction.x * orbitSin + direction.y * orbitCos) * boss.speed;
+        } else {
+            // Apply friction when not moving towards Superman
+            boss.velocity *= 0.9f;
         }
     }
 }
 
-void Ghost::drawGhostBody(sf::RenderWindow& window) {
+BehaviorScript Ghost::runBossAttacks(ScriptScheduler& scripts, Ghost& boss) {
+    // Every BOSS_ATTACK_SECONDS, a burst of volleys from the next barrage
+    float angle = 0.0f;
+    co_await scripts.wait(BOSS_ATTACK_SECONDS);
+    for (std::size_t attack = 0;; ++attack) {
+        const BossBarrage& barrage = BOSS_BARRAGES[attack % std::size(BOSS_BARRAGES)];
+        for (int volleyIndex = 0; volleyIndex < barrage.volleys; ++volleyIndex) {
+            if (volleyIndex > 0) {
+                co_await scripts.wait(barrage.interval);
+            }
+            
+            BulletVolley volley;
+            volley.pattern = barrage.pattern;
+            volley.origin = boss.position;
+            volley.target = boss.targetPosition;
+            volley.count = barrage.count;
+            volley.speed = barrage.speed;
+            volley.angle = angle;
+            volley.spread = barrage.spread;
+            volley.curl = barrage.curl;
+            boss.bullets.fire(volley);
+            angle += barrage.turn;
+        }
+        
+        // The rest of the cooldown; every burst is shorter than it
+        co_await scripts.wait(BOSS_ATTACK_SECONDS - (barrage.volleys - 1) * barrage.interval);
+    }
+}
+
+void Ghost::drawGhostBody(const GhostSnapshot& snapshot, RenderQueue& queue, int tailSegments) {
+    const sf::Vector2f& position = snapshot.position;
+    const float size = snapshot.size;
+    
     // Main ghost body (circle)
-    sf::CircleShape body(size * 0.8f);
-    body.setFillColor(ghostColor);
-    body.setPosition(position.x - size * 0.8f, position.y - size * 0.8f);
-    window.draw(body);
+    queue.submitCircle(RenderLayer::Ghosts, position, size * 0.8f, snapshot.color);
     
-    // Ghost tail (wavy bottom part)
-    for (int i = 0; i < 5; ++i) {
-        float waveOffset = std::sin(animationTimer * 4.0f + i * 0.5f) * 3.0f;
-        sf::CircleShape tailPart(size * 0.15f);
-        tailPart.setFillColor(ghostColor);
-        tailPart.setPosition(
-            position.x - size * 0.6f + i * (size * 0.3f),
-            position.y + size * 0.4f + waveOffset
+    // Ghost tail (wavy bottom part); fewer segments keep the same span
+    const float segmentSpacing = tailSegments > 1 ? size * 1.2f / (tailSegments - 1) : 0.0f;
+    for (int i = 0; i < tailSegments; ++i) {
+        float waveOffset = std::sin(snapshot.animationTimer * 4.0f + i * 0.5f) * 3.0f;
+        sf::Vector2f tailCenter(
+            position.x - size * 0.45f + i * segmentSpacing,
+            position.y + size * 0.55f + waveOffset
         );
-        window.draw(tailPart);
+        queue.submitCircle(RenderLayer::Ghosts, tailCenter, size * 0.15f, snapshot.color);
     }
 }
 
-void Ghost::drawGhostFace(sf::RenderWindow& window) {
-    // Eyes
-    sf::CircleShape leftEye(size * 0.1f);
-    sf::CircleShape rightEye(size * 0.1f);
-    
-    leftEye.setFillColor(sf::Color::Black);
-    rightEye.setFillColor(sf::Color::Black);
-    
-    leftEye.setPosition(position.x - size * 0.3f, position.y - size * 0.2f);
-    rightEye.setPosition(position.x + size * 0.1f, position.y - size * 0.2f);
+void Ghost::drawGhostFace(const GhostSnapshot& snapshot, RenderQueue& queue) {
+    const sf::Vector2f& position = snapshot.position;
+    const float size = snapshot.size;
     
-    window.draw(leftEye);
-    window.draw(rightEye);
+    // Eyes
+    queue.submitCircle(RenderLayer::Ghosts, sf::Vector2f(position.x - size * 0.2f, position.y - size * 0.1f),
+                       size * 0.1f, sf::Color::Black);
+    queue.submitCircle(RenderLayer::Ghosts, sf::Vector2f(position.x + size * 0.2f, position.y - size * 0.1f),
+                       size * 0.1f, sf::Color::Black);
     
     // Mouth (simple oval)
-    sf::CircleShape mouth(size * 0.15f);
-    mouth.setFillColor(sf::Color::Black);
-    mouth.setPosition(position.x - size * 0.15f, position.y + size * 0.1f);
-    mouth.setScale(1.0f, 0.5f); // Flatten to make oval
-    window.draw(mouth);
+    queue.submitEllipse(RenderLayer::Ghosts, sf::Vector2f(position.x, position.y + size * 0.175f),
+                        sf::Vector2f(size * 0.15f, size * 0.075f), sf::Color::Black);
 }
 
-void Ghost::drawBossEffects(sf::RenderWindow& window) {
+void Ghost::drawBossEffects(const GhostSnapshot& snapshot, RenderQueue& queue) {
+    const sf::Vector2f& position = snapshot.position;
+    const float size = snapshot.size;
+    
     // Glowing aura effect for boss
-    sf::CircleShape aura(size * 1.2f);
-    aura.setFillColor(sf::Color(255, 100, 100, 32)); // Very transparent red
-    aura.setPosition(position.x - size * 1.2f, position.y - size * 1.2f);
-    window.draw(aura);
+    queue.submitCircle(RenderLayer::Ghosts, position, size * 1.2f, sf::Color(255, 100, 100, 32)); // Very transparent red
     
     // Pulsing effect
-    float pulse = 1.0f + 0.2f * std::sin(animationTimer * 6.0f);
-    sf::CircleShape pulseEffect(size * 0.5f * pulse);
-    pulseEffect.setFillColor(sf::Color(255, 0, 0, 64));
-    pulseEffect.setPosition(position.x - size * 0.5f * pulse, position.y - size * 0.5f * pulse);
-    window.draw(pulseEffect);
+    float pulse = 1.0f + 0.2f * std::sin(snapshot.animationTimer * 6.0f);
+    queue.submitCircle(RenderLayer::Ghosts, position, size * 0.5f * pulse, sf::Color(255, 0, 0, 64));
 }
\ No newline at end of file
@@ -1,23 +1,34 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include "BulletEngine.h"
+#include "BehaviorScript.h"
+#include "GhostTypes.h"
 
-enum class GhostType {
-    Regular,
-    Fast,
-    Boss
-};
+struct GhostSnapshot;
+class RenderQueue;
 
 class Ghost {
 public:
-    Ghost(sf::Vector2f startPosition, GhostType type = GhostType::Regular);
-    ~Ghost();
+    // The type must outlive the ghost
+    Ghost(sf::Vector2f startPosition, const GhostTypeDef& type, BulletEngine& bullets, ScriptScheduler& scripts);
+    
+    // Boss scripts keep a reference to their ghost, so it must stay where it is
+    Ghost(const Ghost&) = delete;
+    Ghost& operator=(const Ghost&) = delete;
+    Ghost(Ghost&&) = delete;
+    Ghost& operator=(Ghost&&) = delete;
     
     void update(float deltaTime, sf::Vector2f supermanPosition);
-    void render(sf::RenderWindow& window);
     
-    // AI Behavior
-    void moveTowardsSuperman(sf::Vector2f supermanPosition, float deltaTime);
+    // Rendering works from snapshots so it can run on the render thread
+    void writeSnapshot(GhostSnapshot& snapshot) const;
+    static void render(const GhostSnapshot& snapshot, RenderQueue& queue, int tailSegments = 5);
+    static sf::FloatRect getRenderBounds(const GhostSnapshot& snapshot);
+    
+    // AI Behavior: non-boss ghosts run their type's program in batches (see GhostVM)
+    void writeLane(GhostLanes& lanes) const;
+    void readLane(const GhostLanes& lanes, std::size_t lane);
     void avoidOtherGhosts(float deltaTime);
     void updateFloatingAnimation(float deltaTime);
     
@@ -33,7 +44,9 @@ public:
     
     // Game mechanics
     int getScoreValue() const;
-    GhostType getType() const { return type; }
+    const GhostTypeDef& getType() const { return type; }
+    
+    static const float AI_INTERVAL;
     
 private:
     // Core properties
@@ -42,7 +55,7 @@ private:
     sf::Vector2f basePosition; // For floating animation
     float health;
     float maxHealth;
-    GhostType type;
+    const GhostTypeDef& type;
     
     // Movement and AI
     float speed;
@@ -61,21 +74,22 @@ private:
     float transparency;
     float size;
     
-    // Behavior timers
-    float aiUpdateTimer;
-    float damageTimer;
+    sf::Vector2f targetPosition; // Superman as of the last update, for the AI
     
-    // Boss specific
-    float bossAttackTimer;
-    float bossAttackCooldown;
+    // Boss specific: behavior scripts move the boss and fire barrages into the
+    // game's bullet engine
+    BulletEngine& bullets;
+    BehaviorScript bossMovement;
+    BehaviorScript bossAttacks;
     
     // Helper methods
     void initializeByType();
     void updateAnimation(float deltaTime);
-    void updateBossAttack(float deltaTime, sf::Vector2f supermanPosition);
-    void drawGhostBody(sf::RenderWindow& window);
-    void drawGhostFace(sf::RenderWindow& window);
-    void drawBossEffects(sf::RenderWindow& window);
+    static BehaviorScript runBossMovement(ScriptScheduler& scripts, Ghost& boss);
+    static BehaviorScript runBossAttacks(ScriptScheduler& scripts, Ghost& boss);
+    static void drawGhostBody(const GhostSnapshot& snapshot, RenderQueue& queue, int tailSegments);
+    static void drawGhostFace(const GhostSnapshot& snapshot, RenderQueue& queue);
+    static void drawBossEffects(const GhostSnapshot& snapshot, RenderQueue& queue);
     
     // Constants
     static const float BASE_SIZE;
@@ -0,0 +1,295 @@
+#include "GhostTypes.h"
+#include "Logger.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// The original three types; used until a data file loads, and if none does
+const char* const DEFAULT_GHOST_TYPES = R"(
+type regular
+    health 20
+    speed 80
+    aggro 200
+    damage 10
+    color 255 255 255
+    score 10
+    spawn_weight 0.7
+    ai
+        aim
+        near
+        jitter 0.3
+        move
+        far
+        damp 0.9
+    end
+
+type fast
+    health 15
+    speed 150
+    aggro 250
+    damage 15
+    size 0.8
+    float_frequency 4
+    color 200 200 255
+    score 20
+    spawn_weight 0.3
+    ai
+        aim
+        near
+        jitter 0.3
+        move
+        far
+        damp 0.9
+    end
+
+type boss
+    health 50
+    speed 60
+    aggro 300
+    damage 20
+    size 1.5
+    float_amplitude 15
+    color 255 200 200
+    score 50
+    boss_every 3
+)";
+
+struct FloatStat {
+    const char* name;
+    float GhostTypeDef::* field;
+};
+
+const FloatStat FLOAT_STATS[] = {
+    { "health", &GhostTypeDef::health },
+    { "speed", &GhostTypeDef::speed },
+    { "aggro", &GhostTypeDef::aggroRange },
+    { "damage", &GhostTypeDef::damage },
+    { "size", &GhostTypeDef::sizeScale },
+    { "float_amplitude", &GhostTypeDef::floatingAmplitude },
+    { "float_frequency", &GhostTypeDef::floatingFrequency },
+    { "spawn_weight", &GhostTypeDef::spawnWeight }
+};
+
+struct Mnemonic {
+    const char* name;
+    GhostOp op;
+    bool hasOperand;
+};
+
+const Mnemonic MNEMONICS[] = {
+    { "aim", GhostOp::Aim, false },
+    { "near", GhostOp::Near, false },
+    { "far", GhostOp::Far, false },
+    { "all", GhostOp::All, false },
+    { "jitter", GhostOp::Jitter, true },
+    { "turn", GhostOp::Turn, true },
+    { "move", GhostOp::Move, false },
+    { "damp", GhostOp::Damp, true }
+};
+
+const std::size_t MAX_CONSTANTS = 256; // Operands are one byte
+
+bool readColor(std::istringstream& words, sf::Color& color) {
+    int red, green, blue;
+    if (!(words >> red >> green >> blue) || red < 0 || red > 255 || green < 0 || green > 255 || blue < 0 || blue > 255) {
+        return false;
+    }
+    color = sf::Color(static_cast<sf::Uint8>(red), static_cast<sf::Uint8>(green), static_cast<sf::Uint8>(blue));
+    return true;
+}
+
+// One line of an ai block to an instruction; turn angles are stored as cos, sin
+bool assemble(const std::string& mnemonic, std::istringstream& words, GhostProgram& program) {
+    for (const Mnemonic& entry : MNEMONICS) {
+        if (mnemonic != entry.name) {
+            continue;
+        }
+
+        GhostInstruction instruction{ entry.op, 0 };
+        if (entry.hasOperand) {
+            float value;
+            if (!(words >> value) || program.constants.size() + 2 > MAX_CONSTANTS) {
+                return false;
+            }
+            instruction.operand = static_cast<std::uint8_t>(program.constants.size());
+            if (entry.op == GhostOp::Turn) {
+                const float radians = value * 3.14159265f / 180.0f;
+                program.constants.push_back(std::cos(radians));
+                program.constants.push_back(std::sin(radians));
+            } else {
+                program.constants.push_back(value);
+            }
+        }
+        program.code.push_back(instruction);
+        return true;
+    }
+    return false;
+}
+
+}
+
+GhostTypeCatalog::GhostTypeCatalog()
+    : totalSpawnWeight(0.0f) {
+    loadDefaults();
+}
+
+bool GhostTypeCatalog::loadFromFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    return parse(text.str(), filename);
+}
+
+bool GhostTypeCatalog::loadFromMemory(const void* data, std::size_t size) {
+    return parse(std::string(static_cast<const char*>(data), size), "memory");
+}
+
+void GhostTypeCatalog::loadDefaults() {
+    parse(DEFAULT_GHOST_TYPES, "built-in types");
+}
+
+const GhostTypeDef* GhostTypeCatalog::find(const std::string& name) const {
+    for (const GhostTypeDef& type : types) {
+        if (type.name == name) {
+            return &type;
+        }
+    }
+    return nullptr;
+}
+
+const GhostTypeDef* GhostTypeCatalog::findBossFor(int level) const {
+    for (const GhostTypeDef& type : types) {
+        if (type.isBoss() && level % type.bossEvery == 0) {
+            return &type;
+        }
+    }
+    return nullptr;
+}
+
+const GhostTypeDef& GhostTypeCatalog::pickByWeight(float roll) const {
+    // parse() makes sure at least one non-boss type has a weight
+    float remaining = roll * totalSpawnWeight;
+    const GhostTypeDef* picked = nullptr;
+    for (const GhostTypeDef& type : types) {
+        if (type.isBoss() || type.spawnWeight <= 0.0f) {
+            continue;
+        }
+        picked = &type;
+        remaining -= type.spawnWeight;
+        if (remaining < 0.0f) {
+            break;
+        }
+    }
+    return *picked;
+}
+
+bool GhostTypeCatalog::parse(const std::string& text, const std::string& source) {
+    std::vector<GhostTypeDef> parsed;
+    bool inProgram = false;
+    int lineNumber = 0;
+
+    auto fail = [&](const char* message) {
+        LOG_WARNING("GhostTypes", "%s:%d: %s", source.c_str(), lineNumber, message);
+        return false;
+    };
+
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        std::string keyword;
+        if (!(words >> keyword)) {
+            continue;
+        }
+
+        bool understood = true;
+        if (keyword == "type") {
+            std::string name;
+            if (inProgram) {
+                return fail("ai block is missing its end");
+            }
+            if (!(words >> name)) {
+                return fail("type needs a name");
+            }
+            for (const GhostTypeDef& type : parsed) {
+                if (type.name == name) {
+                    return fail("type defined twice");
+                }
+            }
+            parsed.emplace_back();
+            parsed.back().name = name;
+        } else if (parsed.empty()) {
+            return fail("expected 'type <name>' first");
+        } else if (inProgram) {
+            if (keyword == "end") {
+                inProgram = false;
+            } else {
+                understood = assemble(keyword, words, parsed.back().ai);
+            }
+        } else if (keyword == "ai") {
+            inProgram = true;
+            understood = parsed.back().ai.isEmpty();
+        } else if (keyword == "color") {
+            understood = readColor(words, parsed.back().color);
+        } else if (keyword == "score") {
+            understood = static_cast<bool>(words >> parsed.back().score);
+        } else if (keyword == "boss_every") {
+            understood = static_cast<bool>(words >> parsed.back().bossEvery) && parsed.back().bossEvery >= 0;
+        } else {
+            understood = false;
+            for (const FloatStat& stat : FLOAT_STATS) {
+                if (keyword == stat.name) {
+                    understood = static_cast<bool>(words >> (parsed.back().*stat.field));
+                    break;
+                }
+            }
+        }
+
+        std::string extra;
+        if (!understood || words >> extra) {
+            return fail("not understood");
+        }
+    }
+    if (inProgram) {
+        return fail("ai block is missing its end");
+    }
+
+    float spawnWeight = 0.0f;
+    for (std::size_t i = 0; i < parsed.size(); ++i) {
+        GhostTypeDef& type = parsed[i];
+        if (type.health <= 0.0f || type.sizeScale <= 0.0f || type.spawnWeight < 0.0f) {
+            LOG_WARNING("GhostTypes", "%s: type %s needs positive health and size and a spawn_weight of 0 or more", source.c_str(), type.name.c_str());
+            return false;
+        }
+        if (type.isBoss() && !type.ai.isEmpty()) {
+            LOG_WARNING("GhostTypes", "%s: boss type %s moves by its scripts and cannot have an ai block",
+                        source.c_str(), type.name.c_str());
+            return false;
+        }
+
+        type.id = i;
+        if (!type.ai.isEmpty()) {
+            type.ai.code.push_back(GhostInstruction{ GhostOp::End, 0 });
+            GhostVM::prepare(type.ai);
+        }
+        if (!type.isBoss()) {
+            spawnWeight += type.spawnWeight;
+        }
+    }
+    if (spawnWeight <= 0.0f) {
+        LOG_WARNING("GhostTypes", "%s: no non-boss type has a spawn_weight", source.c_str());
+        return false;
+    }
+
+    types.swap(parsed);
+    totalSpawnWeight = spawnWeight;
+    LOG_INFO("GhostTypes", "Loaded %zu ghost types from %s", types.size(), source.c_str());
+    return true;
+}
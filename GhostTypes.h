@@ -0,0 +1,66 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "GhostVM.h"
+
+// Everything that sets one kind of ghost apart: stats, look, how it spawns
+// and the AI program its ghosts run
+struct GhostTypeDef {
+    std::string name;
+    std::size_t id = 0; // Index in the catalog
+    float health = 20.0f;
+    float speed = 80.0f;
+    float aggroRange = 200.0f;
+    float damage = 10.0f;
+    float sizeScale = 1.0f; // Of Ghost's base size
+    float floatingAmplitude = 10.0f;
+    float floatingFrequency = 2.0f;
+    sf::Color color = sf::Color::White;
+    int score = 10;
+    float spawnWeight = 0.0f; // Chance among the non-boss types, relative to their total
+    int bossEvery = 0;        // Bosses spawn as the last ghost of every bossEvery-th level
+    GhostProgram ai;          // Empty for bosses, which move by their behavior scripts
+
+    bool isBoss() const { return bossEvery > 0; }
+};
+
+// Ghost types read from a text file, so designers can add and tune them
+// without a rebuild. Ghosts keep references into the catalog: load it before
+// spawning any. A file that fails to parse changes nothing.
+//
+//     type <name>              # starts a type; the other lines fill it in
+//     health 20                # also speed, aggro, damage, size (scale),
+//     color 255 255 255        #   score, float_amplitude, float_frequency,
+//     spawn_weight 0.7         #   boss_every <levels>
+//     ai                       # program run every AI tick, assembled to bytecode:
+//         aim                  #   aim, near, far, all, move,
+//         near                 #   jitter <amount>, turn <degrees>, damp <factor>
+//         jitter 0.3
+//         move
+//     end
+class GhostTypeCatalog {
+public:
+    // Starts with the built-in types
+    GhostTypeCatalog();
+
+    bool loadFromFile(const std::string& filename);
+    bool loadFromMemory(const void* data, std::size_t size);
+    void loadDefaults();
+
+    std::size_t getCount() const { return types.size(); }
+    const GhostTypeDef& get(std::size_t id) const { return types[id]; }
+    const GhostTypeDef* find(const std::string& name) const;
+
+    // Spawning: the boss due on a level, if any, and a weighted pick of the rest
+    const GhostTypeDef* findBossFor(int level) const;
+    const GhostTypeDef& pickByWeight(float roll) const; // roll in [0, 1)
+
+private:
+    std::vector<GhostTypeDef> types;
+    float totalSpawnWeight;
+
+    bool parse(const std::string& text, const std::string& source);
+};
@@ -0,0 +1,200 @@
+#include "GhostVM.h"
+#include "RandomStream.h"
+#include <cmath>
+#include <random>
+
+void GhostLanes::add(sf::Vector2f position, sf::Vector2f target, sf::Vector2f velocity, float speed, float aggroRange) {
+    positionX.push_back(position.x);
+    positionY.push_back(position.y);
+    targetX.push_back(target.x);
+    targetY.push_back(target.y);
+    velocityX.push_back(velocity.x);
+    velocityY.push_back(velocity.y);
+    this->speed.push_back(speed);
+    this->aggroRange.push_back(aggroRange);
+}
+
+void GhostLanes::clear() {
+    positionX.clear();
+    positionY.clear();
+    targetX.clear();
+    targetY.clear();
+    velocityX.clear();
+    velocityY.clear();
+    speed.clear();
+    aggroRange.clear();
+}
+
+GhostVM::GhostVM()
+    : randomSeed(std::random_device()())
+    , randomCounter(0) {
+}
+
+void GhostVM::prepare(GhostProgram& program) {
+    program.threaded.clear();
+#if GHOST_VM_THREADED
+    std::uint32_t unused = 0;
+    const void* const* handlers = interpret(nullptr, nullptr, 0, unused);
+    for (const GhostInstruction& instruction : program.code) {
+        program.threaded.push_back(GhostProgram::ThreadedInstruction{
+            handlers[static_cast<std::size_t>(instruction.op)], instruction.operand });
+    }
+#endif
+}
+
+void GhostVM::execute(const GhostProgram& program, GhostLanes& lanes) {
+    if (program.isEmpty() || lanes.size() == 0) {
+        return;
+    }
+
+    const std::size_t count = lanes.size();
+    lanes.directionX.assign(count, 0.0f);
+    lanes.directionY.assign(count, 0.0f);
+    lanes.distance.assign(count, 0.0f);
+    lanes.selected.assign(count, 1);
+    interpret(&program, &lanes, randomSeed, randomCounter);
+}
+
+// The default is a switch in a loop; threaded builds jump straight from one
+// handler to the next through the addresses prepare() stored. Either way
+// each handler is a plain loop over the lanes.
+#if GHOST_VM_THREADED
+#define GHOST_DISPATCH() goto *pc->handler;
+#define GHOST_OP(name) op##name:
+#define GHOST_NEXT() do { ++pc; goto *pc->handler; } while (0)
+#else
+#define GHOST_DISPATCH() for (;; ++pc) switch (pc->op)
+#define GHOST_OP(name) case GhostOp::name:
+#define GHOST_NEXT() continue
+#endif
+
+const void* const* GhostVM::interpret(const GhostProgram* program, GhostLanes* lanes, std::uint32_t seed,
+                                      std::uint32_t& counter) {
+#if GHOST_VM_THREADED
+    static const void* const HANDLERS[GHOST_OP_COUNT] = {
+        &&opEnd, &&opAim, &&opNear, &&opFar, &&opAll, &&opJitter, &&opTurn, &&opMove, &&opDamp
+    };
+    if (!program) {
+        return HANDLERS;
+    }
+    const GhostProgram::ThreadedInstruction* pc = program->threaded.data();
+#else
+    if (!program) {
+        return nullptr;
+    }
+    const GhostInstruction* pc = program->code.data();
+#endif
+
+    const std::size_t count = lanes->size();
+    const float* constants = program->constants.data();
+    const float* positionX = lanes->positionX.data();
+    const float* positionY = lanes->positionY.data();
+    const float* targetX = lanes->targetX.data();
+    const float* targetY = lanes->targetY.data();
+    const float* speed = lanes->speed.data();
+    const float* aggroRange = lanes->aggroRange.data();
+    float* velocityX = lanes->velocityX.data();
+    float* velocityY = lanes->velocityY.data();
+    float* directionX = lanes->directionX.data();
+    float* directionY = lanes->directionY.data();
+    float* distance = lanes->distance.data();
+    std::uint8_t* selected = lanes->selected.data();
+
+    GHOST_DISPATCH() {
+        GHOST_OP(End) {
+            return nullptr;
+        }
+
+        GHOST_OP(Aim) {
+            for (std::size_t i = 0; i < count; ++i) {
+                const float dx = targetX[i] - positionX[i];
+                const float dy = targetY[i] - positionY[i];
+                const float length = std::sqrt(dx * dx + dy * dy);
+                const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+                distance[i] = length;
+                directionX[i] = dx * scale;
+                directionY[i] = dy * scale;
+            }
+            GHOST_NEXT();
+        }
+
+        GHOST_OP(Near) {
+            for (std::size_t i = 0; i < count; ++i) {
+                selected[i] = distance[i] > 0.0f && distance[i] <= aggroRange[i];
+            }
+            GHOST_NEXT();
+        }
+
+        GHOST_OP(Far) {
+            for (std::size_t i = 0; i < count; ++i) {
+                selected[i] = !(distance[i] > 0.0f && distance[i] <= aggroRange[i]);
+            }
+            GHOST_NEXT();
+        }
+
+        GHOST_OP(All) {
+            for (std::size_t i = 0; i < count; ++i) {
+                selected[i] = 1;
+            }
+            GHOST_NEXT();
+        }
+
+        GHOST_OP(Jitter) {
+            const float amount = constants[pc->operand];
+            for (std::size_t i = 0; i < count; ++i) {
+                if (selected[i]) {
+                    const std::uint32_t draw = counter + static_cast<std::uint32_t>(i) * 2;
+                    directionX[i] += (randomUnit(seed, draw) * 2.0f - 1.0f) * amount;
+                    directionY[i] += (randomUnit(seed, draw + 1) * 2.0f - 1.0f) * amount;
+                }
+            }
+            counter += static_cast<std::uint32_t>(count) * 2;
+            GHOST_NEXT();
+        }
+
+        GHOST_OP(Turn) {
+            const float cosine = constants[pc->operand];
+            const float sine = constants[pc->operand + 1];
+            for (std::size_t i = 0; i < count; ++i) {
+                if (selected[i]) {
+                    const float x = directionX[i];
+                    const float y = directionY[i];
+                    directionX[i] = x * cosine - y * sine;
+                    directionY[i] = x * sine + y * cosine;
+                }
+            }
+            GHOST_NEXT();
+        }
+
+        GHOST_OP(Move) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (selected[i]) {
+                    velocityX[i] = directionX[i] * speed[i];
+                    velocityY[i] = directionY[i] * speed[i];
+                }
+            }
+            GHOST_NEXT();
+        }
+
+        GHOST_OP(Damp) {
+            const float factor = constants[pc->operand];
+            for (std::size_t i = 0; i < count; ++i) {
+                if (selected[i]) {
+                    velocityX[i] *= factor;
+                    velocityY[i] *= factor;
+                }
+            }
+            GHOST_NEXT();
+        }
+
+#if !GHOST_VM_THREADED
+        default:
+            return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+#undef GHOST_DISPATCH
+#undef GHOST_OP
+#undef GHOST_NEXT
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Dispatch is a switch loop. Handlers loop over a whole batch, so dispatch is a
+// small share of the cost and direct threading measured no faster. Defining
+// GHOST_VM_THREADED_DISPATCH selects it on GCC and Clang (labels-as-values).
+#if (defined(__GNUC__) || defined(__clang__)) && defined(GHOST_VM_THREADED_DISPATCH)
+#define GHOST_VM_THREADED 1
+#else
+#define GHOST_VM_THREADED 0
+#endif
+
+// Ghost AI instructions. Each one works on every lane of a batch before the
+// next is dispatched; lane-wise ones only touch the selected lanes.
+enum class GhostOp : std::uint8_t {
+    End,    // Stop
+    Aim,    // direction = unit vector towards the target, distance = how far it is
+    Near,   // Select the lanes with the target in aggro range
+    Far,    // Select the others
+    All,    // Select every lane
+    Jitter, // direction += random in [-k, k] on each axis
+    Turn,   // Rotate direction; operand is cos, sin
+    Move,   // velocity = direction * speed
+    Damp,   // velocity *= k
+    Count
+};
+
+const std::size_t GHOST_OP_COUNT = static_cast<std::size_t>(GhostOp::Count);
+
+// Two bytes: the opcode and an index into the program's constants
+struct GhostInstruction {
+    GhostOp op;
+    std::uint8_t operand;
+};
+
+struct GhostProgram {
+    std::vector<GhostInstruction> code; // Ends with GhostOp::End
+    std::vector<float> constants;
+
+    // Threaded form of code, one handler address per instruction; see GhostVM::prepare()
+    struct ThreadedInstruction {
+        const void* handler;
+        std::uint32_t operand;
+    };
+    std::vector<ThreadedInstruction> threaded;
+
+    bool isEmpty() const { return code.empty(); }
+};
+
+// Working set of one batch: a ghost per lane, each field a parallel array.
+// Ghosts write themselves in, the VM runs, and they read their velocity back.
+struct GhostLanes {
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> targetX;
+    std::vector<float> targetY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<float> speed;
+    std::vector<float> aggroRange;
+
+    // Scratch the program works in
+    std::vector<float> directionX;
+    std::vector<float> directionY;
+    std::vector<float> distance;
+    std::vector<std::uint8_t> selected;
+
+    void add(sf::Vector2f position, sf::Vector2f target, sf::Vector2f velocity, float speed, float aggroRange);
+    void clear();
+    std::size_t size() const { return positionX.size(); }
+};
+
+// Interpreter for ghost AI programs. A program runs once per batch, so the
+// dispatch cost is per instruction rather than per ghost.
+class GhostVM {
+public:
+    GhostVM();
+
+    // Fills in program.threaded; a program must be prepared once before it runs
+    static void prepare(GhostProgram& program);
+
+    void execute(const GhostProgram& program, GhostLanes& lanes);
+
+private:
+    // With no program, returns the handler table instead of running (threaded builds)
+    static const void* const* interpret(const GhostProgram* program, GhostLanes* lanes, std::uint32_t seed,
+                                        std::uint32_t& counter);
+
+    std::uint32_t randomSeed;
+    std::uint32_t randomCounter; // Position in the random stream
+};
@@ -0,0 +1,401 @@
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+
+namespace {
+    const std::chrono::milliseconds WRITER_IDLE_WAIT(10);
+    const std::uint32_t DEFAULT_RATE_LIMIT = 20;
+    const std::uint64_t DEFAULT_RATE_WINDOW_NS = 1000000000ull;
+
+    const char* levelName(LogLevel level) {
+        switch (level) {
+            case LogLevel::Debug: return "DEBUG";
+            case LogLevel::Info: return "INFO";
+            case LogLevel::Warning: return "WARNING";
+            case LogLevel::Error: return "ERROR";
+            default: return "";
+        }
+    }
+
+    std::chrono::steady_clock::time_point startTime() {
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return start;
+    }
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : slots(new Slot[CAPACITY])
+    , enqueuePos(0)
+    , dequeuePos(0)
+    , rateLimitSites(new std::atomic<std::uint64_t>[RATE_LIMIT_SITES])
+    , rateLimitMax(DEFAULT_RATE_LIMIT)
+    , rateLimitWindowNs(DEFAULT_RATE_WINDOW_NS)
+    , minLevel(static_cast<std::uint8_t>(LogLevel::Info))
+    , written(0)
+    , dropped(0)
+    , suppressed(0)
+    , running(true)
+    , synchronous(false)
+    , binaryFile(nullptr) {
+    startTime();
+    for (std::size_t i = 0; i < CAPACITY; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < RATE_LIMIT_SITES; ++i) {
+        rateLimitSites[i].store(0, std::memory_order_relaxed);
+    }
+
+    writer = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    shutdown();
+    if (binaryFile) {
+        std::fclose(binaryFile);
+    }
+}
+
+void Logger::setRateLimit(std::uint32_t maxPerWindow, float windowSeconds) {
+    rateLimitMax.store(maxPerWindow, std::memory_order_relaxed);
+    rateLimitWindowNs.store(static_cast<std::uint64_t>(std::max(windowSeconds, 0.001f) * 1e9f),
+                            std::memory_order_relaxed);
+}
+
+bool Logger::setBinaryOutput(const std::string& filename) {
+    // Everything queued so far goes to the old output
+    flush();
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    if (binaryFile) {
+        std::fclose(binaryFile);
+        binaryFile = nullptr;
+    }
+    if (filename.empty()) {
+        return true;
+    }
+    binaryFile = std::fopen(filename.c_str(), "wb");
+    return binaryFile != nullptr;
+}
+
+std::uint64_t Logger::now() const {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime()).count());
+}
+
+bool Logger::admit(const char* site, std::uint64_t timestamp, std::uint32_t& suppressedBefore) {
+    const std::uint32_t limit = rateLimitMax.load(std::memory_order_relaxed);
+    if (limit == 0) {
+        return true;
+    }
+
+    // Call sites are identified by their format string; collisions only share a budget
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(site);
+    address ^= address >> 17;
+    address *= 0x9E3779B1u;
+    std::atomic<std::uint64_t>& entry = rateLimitSites[(address >> 8) & (RATE_LIMIT_SITES - 1)];
+
+    const std::uint64_t window = timestamp / rateLimitWindowNs.load(std::memory_order_relaxed);
+    const std::uint32_t windowTag = static_cast<std::uint32_t>(window);
+
+    std::uint64_t state = entry.load(std::memory_order_relaxed);
+    for (;;) {
+        const std::uint32_t stateWindow = static_cast<std::uint32_t>(state >> 32);
+        const std::uint32_t count = static_cast<std::uint32_t>(state);
+
+        std::uint64_t next;
+        std::uint32_t overflow = 0;
+        if (stateWindow != windowTag) {
+            // First message of a new window reports what the last window dropped
+            next = (static_cast<std::uint64_t>(windowTag) << 32) | 1u;
+            overflow = count > limit ? count - limit : 0;
+        } else {
+            next = state + 1;
+        }
+
+        if (entry.compare_exchange_weak(state, next, std::memory_order_relaxed)) {
+            const std::uint32_t newCount = static_cast<std::uint32_t>(next);
+            if (newCount > limit) {
+                suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            suppressedBefore = overflow;
+            return true;
+        }
+    }
+}
+
+Logger::Record* Logger::claim(std::uint64_t& position) {
+    // Bounded MPSC queue: each slot's sequence says whose turn it is
+    position = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots[position & (CAPACITY - 1)];
+        const std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const std::int64_t difference = static_cast<std::int64_t>(sequence - position);
+
+        if (difference == 0) {
+            if (enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                return &slot.record;
+            }
+        } else if (difference < 0) {
+            // Full; the writer is behind
+            return nullptr;
+        } else {
+            position = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::publish(std::uint64_t position) {
+    slots[position & (CAPACITY - 1)].sequence.store(position + 1, std::memory_order_release);
+
+    if (synchronous.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        drain();
+    }
+}
+
+void Logger::PayloadWriter::put(ArgTag tag, const void* value, std::size_t size) {
+    if (truncated || record.payloadSize + 1 + size > PAYLOAD_SIZE) {
+        truncated = true;
+        return;
+    }
+    unsigned char* out = record.payload + record.payloadSize;
+    out[0] = tag;
+    std::memcpy(out + 1, value, size);
+    record.payloadSize = static_cast<std::uint16_t>(record.payloadSize + 1 + size);
+}
+
+void Logger::PayloadWriter::putString(const char* text, std::size_t length) {
+    const std::size_t overhead = 1 + sizeof(std::uint16_t);
+    if (truncated || record.payloadSize + overhead > PAYLOAD_SIZE) {
+        truncated = true;
+        return;
+    }
+    // Long strings are cut to whatever room is left
+    const std::uint16_t stored = static_cast<std::uint16_t>(
+        std::min(length, PAYLOAD_SIZE - record.payloadSize - overhead));
+    unsigned char* out = record.payload + record.payloadSize;
+    out[0] = TagString;
+    std::memcpy(out + 1, &stored, sizeof(stored));
+    std::memcpy(out + overhead, text, stored);
+    record.payloadSize = static_cast<std::uint16_t>(record.payloadSize + overhead + stored);
+}
+
+void Logger::writerLoop() {
+    while (running.load(std::memory_order_acquire)) {
+        bool wroteAny;
+        {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            wroteAny = drain();
+        }
+        if (!wroteAny) {
+            // Producers never signal; polling keeps the log call free of syscalls
+            std::unique_lock<std::mutex> lock(writerMutex);
+            writerWake.wait_for(lock, WRITER_IDLE_WAIT);
+        }
+    }
+}
+
+bool Logger::drain() {
+    bool wroteAny = false;
+    for (;;) {
+        Slot& slot = slots[dequeuePos & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            break;
+        }
+
+        writeRecord(slot.record);
+        slot.sequence.store(dequeuePos + CAPACITY, std::memory_order_release);
+        ++dequeuePos;
+        wroteAny = true;
+    }
+
+    if (wroteAny) {
+        std::fflush(binaryFile ? binaryFile : stdout);
+        std::fflush(stderr);
+    }
+    return wroteAny;
+}
+
+void Logger::flush() {
+    const std::uint64_t target = enqueuePos.load(std::memory_order_acquire);
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            drain();
+            if (dequeuePos >= target) {
+                return;
+            }
+        }
+        // A producer claimed a slot but hasn't published it yet
+        std::this_thread::yield();
+    }
+}
+
+void Logger::shutdown() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    writerWake.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+
+    synchronous.store(true, std::memory_order_release);
+    flush();
+}
+
+void Logger::writeRecord(const Record& record) {
+    written.fetch_add(1, std::memory_order_relaxed);
+    if (binaryFile) {
+        writeBinary(record);
+    } else {
+        writeText(record);
+    }
+}
+
+void Logger::writeText(const Record& record) {
+    std::string line = "[";
+    line += record.category;
+    line += " ";
+    line += levelName(record.level);
+    line += "] ";
+    line += formatRecord(record);
+    if (record.suppressedBefore > 0) {
+        line += " (" + std::to_string(record.suppressedBefore) + " similar messages suppressed)";
+    }
+    line += "\n";
+
+    std::FILE* stream = record.level >= LogLevel::Error ? stderr : stdout;
+    std::fwrite(line.data(), 1, line.size(), stream);
+}
+
+void Logger::writeBinary(const Record& record) {
+    const std::uint8_t level = static_cast<std::uint8_t>(record.level);
+    const std::uint16_t categoryLength = static_cast<std::uint16_t>(std::strlen(record.category));
+    const std::uint16_t formatLength = static_cast<std::uint16_t>(std::strlen(record.format));
+
+    std::fwrite(&record.timestamp, sizeof(record.timestamp), 1, binaryFile);
+    std::fwrite(&level, sizeof(level), 1, binaryFile);
+    std::fwrite(&record.argCount, sizeof(record.argCount), 1, binaryFile);
+    std::fwrite(&record.payloadSize, sizeof(record.payloadSize), 1, binaryFile);
+    std::fwrite(&record.suppressedBefore, sizeof(record.suppressedBefore), 1, binaryFile);
+    std::fwrite(&categoryLength, sizeof(categoryLength), 1, binaryFile);
+    std::fwrite(record.category, 1, categoryLength, binaryFile);
+    std::fwrite(&formatLength, sizeof(formatLength), 1, binaryFile);
+    std::fwrite(record.format, 1, formatLength, binaryFile);
+    std::fwrite(record.payload, 1, record.payloadSize, binaryFile);
+}
+
+std::string Logger::formatRecord(const Record& record) const {
+    std::string out;
+    const unsigned char* payload = record.payload;
+    const unsigned char* payloadEnd = record.payload + record.payloadSize;
+    char buffer[512];
+
+    for (const char* p = record.format; *p; ++p) {
+        if (*p != '%') {
+            out += *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            out += '%';
+            ++p;
+            continue;
+        }
+
+        // Collect flags, width and precision; drop length modifiers
+        const char* specStart = p;
+        std::string spec = "%";
+        ++p;
+        while (*p && std::strchr("-+ #0", *p)) spec += *p++;
+        while (*p && std::isdigit(static_cast<unsigned char>(*p))) spec += *p++;
+        if (*p == '.') {
+            spec += *p++;
+            while (*p && std::isdigit(static_cast<unsigned char>(*p))) spec += *p++;
+        }
+        while (*p && std::strchr("hlLqjzt", *p)) ++p;
+        const char conversion = *p;
+        if (!conversion) {
+            out.append(specStart);
+            break;
+        }
+
+        if (payload >= payloadEnd) {
+            // Missing or truncated argument
+            out.append(specStart, p + 1);
+            continue;
+        }
+
+        const ArgTag tag = static_cast<ArgTag>(*payload++);
+        if (tag == TagString) {
+            std::uint16_t length;
+            std::memcpy(&length, payload, sizeof(length));
+            payload += sizeof(length);
+            const std::string text(reinterpret_cast<const char*>(payload), length);
+            payload += length;
+            spec += 's';
+            std::snprintf(buffer, sizeof(buffer), spec.c_str(), text.c_str());
+            out += buffer;
+            continue;
+        }
+
+        std::uint64_t bits;
+        std::memcpy(&bits, payload, sizeof(bits));
+        payload += sizeof(bits);
+
+        std::int64_t integer;
+        double real;
+        if (tag == TagDouble) {
+            std::memcpy(&real, &bits, sizeof(real));
+            integer = static_cast<std::int64_t>(real);
+        } else {
+            integer = static_cast<std::int64_t>(bits);
+            real = tag == TagInt ? static_cast<double>(integer) : static_cast<double>(bits);
+        }
+
+        // The recorded type wins over the conversion's length; the conversion only picks the style
+        switch (conversion) {
+            case 'd': case 'i':
+                spec += "lld";
+                std::snprintf(buffer, sizeof(buffer), spec.c_str(), static_cast<long long>(integer));
+                break;
+            case 'u': case 'x': case 'X': case 'o':
+                spec += "ll";
+                spec += conversion;
+                std::snprintf(buffer, sizeof(buffer), spec.c_str(), static_cast<unsigned long long>(bits));
+                break;
+            case 'c':
+                spec += 'c';
+                std::snprintf(buffer, sizeof(buffer), spec.c_str(), static_cast<int>(integer));
+                break;
+            case 'p':
+                spec += 'p';
+                std::snprintf(buffer, sizeof(buffer), spec.c_str(),
+                              reinterpret_cast<void*>(static_cast<std::uintptr_t>(bits)));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                spec += conversion;
+                std::snprintf(buffer, sizeof(buffer), spec.c_str(), real);
+                break;
+            default:
+                // %s given a number, or an unknown conversion: print the value plainly
+                if (tag == TagDouble) {
+                    std::snprintf(buffer, sizeof(buffer), "%g", real);
+                } else if (tag == TagInt) {
+                    std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(integer));
+                } else {
+                    std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(bits));
+                }
+                break;
+        }
+        out += buffer;
+    }
+    return out;
+}
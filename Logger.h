@@ -0,0 +1,235 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+enum class LogLevel : std::uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+// Asynchronous logger.
+//
+// Log calls never format or touch a stream. The caller claims a slot in a
+// bounded lock-free MPSC ring, copies the format pointer and the raw argument
+// values into it and returns; a background writer thread formats and writes.
+// Format strings and categories must be string literals (or otherwise outlive
+// the logger) because only their pointers are queued.
+//
+// Formats use printf conversions (%d, %u, %x, %f, %s, %p, %c with the usual
+// flags, width and precision). Length modifiers are accepted but ignored since
+// argument types are recorded with the values.
+//
+// Repeated messages from the same call site are rate limited: past
+// maxPerWindow messages in one window they are dropped and counted, and the
+// next message that gets through reports how many were suppressed.
+//
+// In binary mode records are written unformatted to a file:
+//   u64 timestampNs, u8 level, u8 argCount, u16 payloadSize, u32 suppressed,
+//   u16 categoryLength, category bytes, u16 formatLength, format bytes,
+//   payload (per argument: u8 tag, then 8 value bytes, or u16 length + bytes
+//   for strings)
+class Logger {
+public:
+    static Logger& instance();
+
+    ~Logger();
+
+    // Filtering
+    void setLevel(LogLevel level) { minLevel.store(static_cast<std::uint8_t>(level), std::memory_order_relaxed); }
+    LogLevel getLevel() const { return static_cast<LogLevel>(minLevel.load(std::memory_order_relaxed)); }
+    bool isEnabled(LogLevel level) const {
+        return static_cast<std::uint8_t>(level) >= minLevel.load(std::memory_order_relaxed);
+    }
+
+    // Rate limiting per call site; maxPerWindow of 0 disables it
+    void setRateLimit(std::uint32_t maxPerWindow, float windowSeconds);
+
+    // Structured binary output instead of text; an empty filename switches back to text
+    bool setBinaryOutput(const std::string& filename);
+
+    template <typename... Args>
+    void log(LogLevel level, const char* category, const char* format, const Args&... args);
+
+    // Blocks until everything logged so far has been written
+    void flush();
+    // Drains the queue and stops the writer thread; later messages are written synchronously
+    void shutdown();
+
+    // Statistics
+    std::uint64_t getWrittenCount() const { return written.load(std::memory_order_relaxed); }
+    std::uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+    std::uint64_t getSuppressedCount() const { return suppressed.load(std::memory_order_relaxed); }
+
+    static const std::size_t PAYLOAD_SIZE = 208;
+
+private:
+    enum ArgTag : std::uint8_t {
+        TagInt = 1,
+        TagUnsigned,
+        TagDouble,
+        TagString,
+        TagPointer
+    };
+
+    struct Record {
+        std::uint64_t timestamp;
+        const char* format;
+        const char* category;
+        std::uint32_t suppressedBefore;
+        LogLevel level;
+        std::uint8_t argCount;
+        std::uint16_t payloadSize;
+        unsigned char payload[PAYLOAD_SIZE];
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> sequence;
+        Record record;
+    };
+
+    struct PayloadWriter {
+        Record& record;
+        bool truncated;
+
+        void put(ArgTag tag, const void* value, std::size_t size);
+        void putString(const char* text, std::size_t length);
+    };
+
+    static const std::size_t CAPACITY = 4096; // Power of two
+    static const std::size_t RATE_LIMIT_SITES = 256;
+
+    Logger();
+
+    // Ring buffer
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<std::uint64_t> enqueuePos;
+    alignas(64) std::uint64_t dequeuePos;
+
+    // Rate limiting: per call site, window index in the high 32 bits and count in the low 32
+    std::unique_ptr<std::atomic<std::uint64_t>[]> rateLimitSites;
+    std::atomic<std::uint32_t> rateLimitMax;
+    std::atomic<std::uint64_t> rateLimitWindowNs;
+
+    std::atomic<std::uint8_t> minLevel;
+    std::atomic<std::uint64_t> written;
+    std::atomic<std::uint64_t> dropped;
+    std::atomic<std::uint64_t> suppressed;
+
+    // Writer thread
+    std::thread writer;
+    std::mutex writerMutex;
+    std::condition_variable writerWake;
+    std::atomic<bool> running;
+    std::atomic<bool> synchronous;
+    std::FILE* binaryFile;
+
+    std::uint64_t now() const;
+    bool admit(const char* site, std::uint64_t timestamp, std::uint32_t& suppressedBefore);
+    Record* claim(std::uint64_t& position);
+    void publish(std::uint64_t position);
+
+    void writerLoop();
+    bool drain();
+    void writeRecord(const Record& record);
+    void writeText(const Record& record);
+    void writeBinary(const Record& record);
+    std::string formatRecord(const Record& record) const;
+
+    // Argument encoding
+    static void encode(PayloadWriter& writer) { (void)writer; }
+    template <typename T, typename... Rest>
+    static void encode(PayloadWriter& writer, const T& value, const Rest&... rest) {
+        encodeOne(writer, value);
+        encode(writer, rest...);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    encodeOne(PayloadWriter& writer, T value) {
+        std::int64_t widened = value;
+        writer.put(TagInt, &widened, sizeof(widened));
+    }
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+    encodeOne(PayloadWriter& writer, T value) {
+        std::uint64_t widened = value;
+        writer.put(TagUnsigned, &widened, sizeof(widened));
+    }
+    template <typename T>
+    static typename std::enable_if<std::is_enum<T>::value>::type
+    encodeOne(PayloadWriter& writer, T value) {
+        encodeOne(writer, static_cast<typename std::underlying_type<T>::type>(value));
+    }
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    encodeOne(PayloadWriter& writer, T value) {
+        double widened = value;
+        writer.put(TagDouble, &widened, sizeof(widened));
+    }
+    static void encodeOne(PayloadWriter& writer, const char* text) {
+        text = text ? text : "(null)";
+        writer.putString(text, std::strlen(text));
+    }
+    static void encodeOne(PayloadWriter& writer, const std::string& text) {
+        writer.putString(text.data(), text.size());
+    }
+    template <typename T>
+    static void encodeOne(PayloadWriter& writer, const T* pointer) {
+        std::uint64_t address = reinterpret_cast<std::uintptr_t>(pointer);
+        writer.put(TagPointer, &address, sizeof(address));
+    }
+};
+
+template <typename... Args>
+void Logger::log(LogLevel level, const char* category, const char* format, const Args&... args) {
+    if (!isEnabled(level)) {
+        return;
+    }
+
+    const std::uint64_t timestamp = now();
+    std::uint32_t suppressedBefore = 0;
+    if (!admit(format, timestamp, suppressedBefore)) {
+        return;
+    }
+
+    std::uint64_t position = 0;
+    Record* record = claim(position);
+    if (!record) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    record->timestamp = timestamp;
+    record->format = format;
+    record->category = category;
+    record->suppressedBefore = suppressedBefore;
+    record->level = level;
+    record->argCount = static_cast<std::uint8_t>(sizeof...(Args));
+    record->payloadSize = 0;
+
+    PayloadWriter writer = { *record, false };
+    encode(writer, args...);
+
+    publish(position);
+}
+
+#define LOG_DEBUG(category, ...) \
+    do { if (Logger::instance().isEnabled(LogLevel::Debug)) Logger::instance().log(LogLevel::Debug, category, __VA_ARGS__); } while (0)
+#define LOG_INFO(category, ...) \
+    do { if (Logger::instance().isEnabled(LogLevel::Info)) Logger::instance().log(LogLevel::Info, category, __VA_ARGS__); } while (0)
+#define LOG_WARNING(category, ...) \
+    do { if (Logger::instance().isEnabled(LogLevel::Warning)) Logger::instance().log(LogLevel::Warning, category, __VA_ARGS__); } while (0)
+#define LOG_ERROR(category, ...) \
+    do { if (Logger::instance().isEnabled(LogLevel::Error)) Logger::instance().log(LogLevel::Error, category, __VA_ARGS__); } while (0)
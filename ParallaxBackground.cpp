@@ -0,0 +1,204 @@
+#include "ParallaxBackground.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+    const sf::Color SKY_TOP(6, 6, 22);
+    const sf::Color SKY_HORIZON(14, 14, 38);
+    const sf::Color FAR_WINDOW_COLOR(150, 130, 80);
+
+    sf::Color lerpColor(sf::Color a, sf::Color b, float t) {
+        return sf::Color(
+            static_cast<sf::Uint8>(a.r + (b.r - a.r) * t),
+            static_cast<sf::Uint8>(a.g + (b.g - a.g) * t),
+            static_cast<sf::Uint8>(a.b + (b.b - a.b) * t)
+        );
+    }
+
+    void appendQuad(std::vector<sf::Vertex>& vertices, float left, float top, float width, float height, sf::Color color) {
+        vertices.push_back(sf::Vertex(sf::Vector2f(left, top), color));
+        vertices.push_back(sf::Vertex(sf::Vector2f(left + width, top), color));
+        vertices.push_back(sf::Vertex(sf::Vector2f(left + width, top + height), color));
+        vertices.push_back(sf::Vertex(sf::Vector2f(left, top + height), color));
+    }
+}
+
+ParallaxBackground::ParallaxBackground()
+    : worldHeight(600.0f)
+    , renderCount(0) {
+
+    // Same density as the original 800x600 background: 200 stars
+    ParallaxLayerParams stars;
+    stars.style = ParallaxStyle::Stars;
+    stars.tileSize = sf::Vector2u(512, 512);
+    stars.seed = 0x57A25;
+    stars.density = 200.0f * 1000.0f / (800.0f * 600.0f);
+    stars.color = sf::Color::White;
+    stars.scrollFactor = 0.05f;
+
+    ParallaxLayerParams farCity;
+    farCity.style = ParallaxStyle::Skyline;
+    farCity.tileSize = sf::Vector2u(1024, 320);
+    farCity.seed = 0xC17E;
+    farCity.density = 0.15f;
+    farCity.color = sf::Color(18, 18, 44);
+    farCity.scrollFactor = 0.35f;
+
+    layers[Stars].params = stars;
+    layers[Stars].renderLayer = RenderLayer::Stars;
+    layers[FarCity].params = farCity;
+    layers[FarCity].renderLayer = RenderLayer::FarCity;
+    for (Layer& layer : layers) {
+        layer.dirty = true;
+    }
+}
+
+void ParallaxBackground::setLayer(LayerIndex index, const ParallaxLayerParams& params) {
+    Layer& layer = layers[index];
+    if (affectsPixels(layer.params, params)) {
+        layer.dirty = true;
+    }
+    layer.params = params;
+}
+
+void ParallaxBackground::submit(RenderQueue& queue, sf::Vector2f cameraCenter, sf::Vector2f screenSize) {
+    // Sky gradient over the part of the world the camera sees
+    const float top = std::max(0.0f, std::min(1.0f, (cameraCenter.y - screenSize.y * 0.5f) / worldHeight));
+    const float bottom = std::max(0.0f, std::min(1.0f, (cameraCenter.y + screenSize.y * 0.5f) / worldHeight));
+    const sf::Color topColor = lerpColor(SKY_TOP, SKY_HORIZON, top);
+    const sf::Color bottomColor = lerpColor(SKY_TOP, SKY_HORIZON, bottom);
+    const sf::Vertex sky[4] = {
+        sf::Vertex(sf::Vector2f(0, 0), topColor),
+        sf::Vertex(sf::Vector2f(screenSize.x, 0), topColor),
+        sf::Vertex(sf::Vector2f(screenSize.x, screenSize.y), bottomColor),
+        sf::Vertex(sf::Vector2f(0, screenSize.y), bottomColor)
+    };
+    queue.submit(RenderLayer::Sky, sky, 4, sf::Quads);
+
+    for (Layer& layer : layers) {
+        if (layer.dirty) {
+            renderLayer(layer);
+        }
+        submitLayer(queue, layer, cameraCenter, screenSize);
+    }
+}
+
+void ParallaxBackground::renderLayer(Layer& layer) {
+    const ParallaxLayerParams& params = layer.params;
+    if (!layer.texture) {
+        layer.texture.reset(new sf::RenderTexture());
+    }
+    sf::RenderTexture& texture = *layer.texture;
+    if (texture.getSize() != params.tileSize) {
+        texture.create(params.tileSize.x, params.tileSize.y);
+    }
+
+    texture.clear(sf::Color::Transparent);
+    switch (params.style) {
+        case ParallaxStyle::Stars:
+            drawStars(texture, params);
+            break;
+        case ParallaxStyle::Skyline:
+            drawSkyline(texture, params);
+            break;
+    }
+    texture.display();
+    texture.setRepeated(true);
+    texture.setSmooth(false);
+
+    layer.dirty = false;
+    ++renderCount;
+}
+
+void ParallaxBackground::submitLayer(RenderQueue& queue, const Layer& layer, sf::Vector2f cameraCenter,
+                                     sf::Vector2f screenSize) const {
+    const ParallaxLayerParams& params = layer.params;
+    const sf::Texture& texture = layer.texture->getTexture();
+
+    // The texture repeats, so scrolling is just an offset in texture coordinates
+    const float u = cameraCenter.x * params.scrollFactor;
+    float top = 0.0f;
+    float height = screenSize.y;
+    float v = cameraCenter.y * params.scrollFactor;
+
+    if (params.style == ParallaxStyle::Skyline) {
+        // Only tiled horizontally: the band stands on the ground when the camera
+        // is at the bottom of the world and sinks slower than the near city as it rises
+        const float bottom = screenSize.y * 0.5f + (worldHeight - cameraCenter.y) * params.scrollFactor
+            + screenSize.y * 0.5f * (1.0f - params.scrollFactor);
+        height = static_cast<float>(params.tileSize.y);
+        top = bottom - height;
+        v = 0.0f;
+        if (top >= screenSize.y) {
+            return;
+        }
+    }
+
+    const sf::Vertex quad[4] = {
+        sf::Vertex(sf::Vector2f(0, top), sf::Vector2f(u, v)),
+        sf::Vertex(sf::Vector2f(screenSize.x, top), sf::Vector2f(u + screenSize.x, v)),
+        sf::Vertex(sf::Vector2f(screenSize.x, top + height), sf::Vector2f(u + screenSize.x, v + height)),
+        sf::Vertex(sf::Vector2f(0, top + height), sf::Vector2f(u, v + height))
+    };
+    queue.submit(layer.renderLayer, quad, 4, sf::Quads, &texture);
+}
+
+bool ParallaxBackground::affectsPixels(const ParallaxLayerParams& a, const ParallaxLayerParams& b) {
+    return a.style != b.style || a.tileSize != b.tileSize || a.seed != b.seed
+        || a.density != b.density || a.color != b.color;
+}
+
+void ParallaxBackground::drawStars(sf::RenderTarget& target, const ParallaxLayerParams& params) {
+    std::mt19937 rng(params.seed);
+    const unsigned int width = params.tileSize.x;
+    const unsigned int height = params.tileSize.y;
+    const int count = static_cast<int>(params.density * width * height / 1000.0f);
+
+    std::vector<sf::Vertex> vertices;
+    vertices.reserve(static_cast<std::size_t>(count) * 4);
+    for (int i = 0; i < count; ++i) {
+        // Keep whole stars inside the tile so none are cut at the wrap
+        const float size = (rng() % 4 == 0) ? 2.0f : 1.0f;
+        const float x = static_cast<float>(rng() % (width - 2));
+        const float y = static_cast<float>(rng() % (height - 2));
+        sf::Color color = params.color;
+        color.a = static_cast<sf::Uint8>(120 + rng() % 136);
+        appendQuad(vertices, x, y, size, size, color);
+    }
+    target.draw(vertices.data(), vertices.size(), sf::Quads);
+}
+
+void ParallaxBackground::drawSkyline(sf::RenderTarget& target, const ParallaxLayerParams& params) {
+    std::mt19937 rng(params.seed);
+    const int width = static_cast<int>(params.tileSize.x);
+    const float height = static_cast<float>(params.tileSize.y);
+
+    std::vector<sf::Vertex> vertices;
+    int x = 0;
+    while (x < width) {
+        const int gap = 2 + static_cast<int>(rng() % 7);
+        // The last building ends inside the tile, so the wrap falls in a gap
+        const int buildingWidth = std::min(30 + static_cast<int>(rng() % 51), width - x - gap);
+        const float buildingHeight = height * (0.35f + 0.65f * (rng() % 1000) / 1000.0f);
+        if (buildingWidth < 12) {
+            break;
+        }
+
+        const float left = static_cast<float>(x + gap);
+        const float top = height - buildingHeight;
+        appendQuad(vertices, left, top, static_cast<float>(buildingWidth), buildingHeight, params.color);
+
+        // Small, dim windows read as distance
+        for (float wy = top + 6.0f; wy + 5.0f < height; wy += 12.0f) {
+            for (float wx = left + 3.0f; wx + 4.0f < left + buildingWidth - 2.0f; wx += 8.0f) {
+                if ((rng() % 1000) / 1000.0f < params.density) {
+                    appendQuad(vertices, wx, wy, 3.0f, 4.0f, FAR_WINDOW_COLOR);
+                }
+            }
+        }
+
+        x += gap + buildingWidth;
+    }
+    target.draw(vertices.data(), vertices.size(), sf::Quads);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include "RenderQueue.h"
+
+enum class ParallaxStyle : std::uint8_t {
+    Stars,   // Scattered points, tiled in both directions
+    Skyline  // Building silhouettes standing on the bottom edge, tiled horizontally
+};
+
+struct ParallaxLayerParams {
+    ParallaxStyle style = ParallaxStyle::Stars;
+    sf::Vector2u tileSize = sf::Vector2u(512, 512);
+    std::uint32_t seed = 0;
+    float density = 0.0f;   // Stars per 1000 square pixels, or lit window fraction for skylines
+    sf::Color color = sf::Color::White;
+    float scrollFactor = 0.0f; // 0 stays fixed to the screen, 1 moves with the world
+};
+
+// Distant background layers drawn behind the streamed near city. Each layer is
+// rendered once into its own sf::RenderTexture and drawn as a single repeated
+// quad, so a frame costs one sky gradient plus one textured quad per layer.
+// A layer is re-rendered lazily, on the next submit after a parameter that
+// affects its pixels has changed; scroll factor changes only move the quad.
+class ParallaxBackground {
+public:
+    enum LayerIndex {
+        Stars,
+        FarCity,
+        LayerCount
+    };
+
+    ParallaxBackground();
+
+    void setWorldHeight(float height) { worldHeight = height; }
+    void setLayer(LayerIndex index, const ParallaxLayerParams& params);
+    const ParallaxLayerParams& getLayer(LayerIndex index) const { return layers[index].params; }
+
+    // Render thread: regenerates dirty layers, then submits the sky and layers in screen space
+    void submit(RenderQueue& queue, sf::Vector2f cameraCenter, sf::Vector2f screenSize);
+
+    // Number of layer textures rendered so far
+    std::size_t getRenderCount() const { return renderCount; }
+
+private:
+    struct Layer {
+        ParallaxLayerParams params;
+        RenderLayer renderLayer;
+        std::unique_ptr<sf::RenderTexture> texture;
+        bool dirty;
+    };
+
+    std::array<Layer, LayerCount> layers;
+    float worldHeight;
+    std::size_t renderCount;
+
+    void renderLayer(Layer& layer);
+    void submitLayer(RenderQueue& queue, const Layer& layer, sf::Vector2f cameraCenter, sf::Vector2f screenSize) const;
+
+    static bool affectsPixels(const ParallaxLayerParams& a, const ParallaxLayerParams& b);
+    static void drawStars(sf::RenderTarget& target, const ParallaxLayerParams& params);
+    static void drawSkyline(sf::RenderTarget& target, const ParallaxLayerParams& params);
+};
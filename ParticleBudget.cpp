@@ -0,0 +1,126 @@
+#include "ParticleBudget.h"
+#include <algorithm>
+
+ParticleBudget::ParticleBudget(std::size_t typeCount)
+    : types(typeCount)
+    , freeHead(NO_SLOT)
+    , liveCount(0)
+    , limit(0) {
+}
+
+void ParticleBudget::setTypePolicy(std::size_t type, int priority, float quotaFraction) {
+    types[type].priority = priority;
+    types[type].quotaFraction = quotaFraction;
+}
+
+std::int32_t ParticleBudget::allocate(std::size_t type) {
+    TypeState& state = types[type];
+    std::int32_t slot = NO_SLOT;
+
+    const std::size_t quota = std::max<std::size_t>(1, static_cast<std::size_t>(limit * state.quotaFraction));
+    if (state.stats.live >= quota) {
+        // Over quota: the newest effect of a type matters more than its oldest
+        slot = evictOldest(type);
+    } else if (liveCount >= limit) {
+        // Budget full: take from the lowest priority type that does not outrank this one,
+        // the one with the most live particles on a tie
+        std::size_t victim = types.size();
+        for (std::size_t candidate = 0; candidate < types.size(); ++candidate) {
+            const TypeState& other = types[candidate];
+            if (other.stats.live == 0 || other.priority > state.priority) {
+                continue;
+            }
+            if (victim == types.size() || other.priority < types[victim].priority
+                || (other.priority == types[victim].priority && other.stats.live > types[victim].stats.live)) {
+                victim = candidate;
+            }
+        }
+        if (victim == types.size()) {
+            ++state.stats.rejected;
+            return NO_SLOT;
+        }
+        slot = evictOldest(victim);
+    } else if (freeHead != NO_SLOT) {
+        slot = freeHead;
+        freeHead = slots[slot].next;
+    } else {
+        slot = static_cast<std::int32_t>(slots.size());
+        slots.push_back(Slot{ NO_SLOT, NO_SLOT, FREE });
+    }
+
+    link(slot, type);
+    ++state.stats.emitted;
+    return slot;
+}
+
+void ParticleBudget::release(std::int32_t slot) {
+    unlink(slot);
+    slots[slot].type = FREE;
+    slots[slot].prev = NO_SLOT;
+    slots[slot].next = freeHead;
+    freeHead = slot;
+}
+
+void ParticleBudget::clear() {
+    freeHead = NO_SLOT;
+    for (std::int32_t slot = static_cast<std::int32_t>(slots.size()) - 1; slot >= 0; --slot) {
+        slots[slot] = Slot{ NO_SLOT, freeHead, FREE };
+        freeHead = slot;
+    }
+    for (TypeState& state : types) {
+        state.oldest = NO_SLOT;
+        state.newest = NO_SLOT;
+        state.stats.live = 0;
+    }
+    liveCount = 0;
+}
+
+void ParticleBudget::resetStats() {
+    for (TypeState& state : types) {
+        const std::size_t live = state.stats.live;
+        state.stats = ParticleTypeStats();
+        state.stats.live = live;
+    }
+}
+
+std::int32_t ParticleBudget::evictOldest(std::size_t type) {
+    const std::int32_t slot = types[type].oldest;
+    unlink(slot);
+    ++types[type].stats.evicted;
+    return slot;
+}
+
+void ParticleBudget::link(std::int32_t slot, std::size_t type) {
+    TypeState& state = types[type];
+    Slot& entry = slots[slot];
+    entry.type = static_cast<std::uint16_t>(type);
+    entry.prev = state.newest;
+    entry.next = NO_SLOT;
+    if (state.newest != NO_SLOT) {
+        slots[state.newest].next = slot;
+    } else {
+        state.oldest = slot;
+    }
+    state.newest = slot;
+
+    ++state.stats.live;
+    ++liveCount;
+}
+
+void ParticleBudget::unlink(std::int32_t slot) {
+    Slot& entry = slots[slot];
+    TypeState& state = types[entry.type];
+    if (entry.prev != NO_SLOT) {
+        slots[entry.prev].next = entry.next;
+    } else {
+        state.oldest = entry.next;
+    }
+    if (entry.next != NO_SLOT) {
+        slots[entry.next].prev = entry.prev;
+    } else {
+        state.newest = entry.prev;
+    }
+
+    --state.stats.live;
+    --liveCount;
+}
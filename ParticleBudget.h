@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ParticleTypeStats {
+    std::size_t emitted = 0;  // Slots handed out
+    std::size_t evicted = 0;  // Live particles of this type replaced by newer ones
+    std::size_t rejected = 0; // Requests refused because everything live outranked them
+    std::size_t live = 0;
+};
+
+// Slot allocator for a fixed particle budget, shared by several particle
+// types. Each type has a priority and a quota (a fraction of the budget).
+//
+//  - A type at its quota recycles its own oldest particle.
+//  - When the whole budget is in use, the oldest particle of the lowest
+//    priority type that does not outrank the request is evicted.
+//  - Only when every live particle outranks the request is it rejected.
+//
+// Live slots of each type sit in a doubly linked list in allocation order, and
+// dead slots in a free list, so allocate, evict and release are all O(1) (the
+// lowest-priority search only walks the fixed, small set of types).
+class ParticleBudget {
+public:
+    static const std::int32_t NO_SLOT = -1;
+
+    explicit ParticleBudget(std::size_t typeCount);
+
+    void setTypePolicy(std::size_t type, int priority, float quotaFraction);
+    // Lowering the limit does not kill anything; the excess dies off naturally
+    void setLimit(std::size_t maxLive) { limit = maxLive; }
+    std::size_t getLimit() const { return limit; }
+
+    // Returns the slot to fill, possibly one taken from an evicted particle, or NO_SLOT
+    std::int32_t allocate(std::size_t type);
+    void release(std::int32_t slot);
+    void clear();
+
+    // Slots are numbered densely from zero; getSlotCount() only ever grows
+    std::size_t getSlotCount() const { return slots.size(); }
+    bool isLive(std::int32_t slot) const { return slots[slot].type != FREE; }
+    std::size_t getLiveCount() const { return liveCount; }
+
+    const ParticleTypeStats& getStats(std::size_t type) const { return types[type].stats; }
+    void resetStats();
+
+private:
+    static const std::uint16_t FREE = 0xFFFF;
+
+    struct Slot {
+        std::int32_t prev;
+        std::int32_t next;
+        std::uint16_t type; // FREE when on the free list
+    };
+
+    struct TypeState {
+        int priority = 0;
+        float quotaFraction = 1.0f;
+        std::int32_t oldest = NO_SLOT;
+        std::int32_t newest = NO_SLOT;
+        ParticleTypeStats stats;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<TypeState> types;
+    std::int32_t freeHead;
+    std::size_t liveCount;
+    std::size_t limit;
+
+    std::int32_t evictOldest(std::size_t type);
+    void link(std::int32_t slot, std::size_t type);
+    void unlink(std::int32_t slot);
+};
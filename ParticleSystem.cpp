@@ -1,365 +1,580 @@
 #include "ParticleSystem.h"
+#include "RenderSnapshot.h"
+#include "RenderQueue.h"
+#include "RandomStream.h"
 #include <cmath>
 #include <random>
 #include <algorithm>
+#include <type_traits>
+#include <utility>
 
-ParticleSystem::ParticleSystem()
-    : maxParticles(1000) {
-    particles.reserve(maxParticles);
+namespace {
+    enum class ParticleShape {
+        Circle,
+        Streak // Rotated rectangle, twice as long as it is wide
+    };
+    
+    struct Range {
+        float min;
+        float max;
+    };
+    
+    struct Rgb {
+        std::uint8_t r, g, b;
+    };
+    
+    constexpr float PI = 3.14159f;
+    
+    // Everything about a particle type that is fixed at compile time. Priority and quota
+    // go to the budget (short hit feedback outranks long-lived ambience; quotas are fractions
+    // of the budget); the rest is baked into that type's spawn, update and render kernels.
+    //
+    // Spawning: COUNT particles per effect, fired at AIM +- SPREAD radians (or along the
+    // request's direction when AIMED), cycling through COLORS with up to COLOR_JITTER added.
+    // DRAG is the velocity kept per frame at the original 60 FPS.
+    template <ParticleType Type> struct ParticleTraits;
+    
+    template <> struct ParticleTraits<ParticleType::Explosion> {
+        static constexpr const char* NAME = "Explosion";
+        static constexpr int PRIORITY = 2;
+        static constexpr float QUOTA = 0.4f;
+        static constexpr float GRAVITY = 150.0f;
+        static constexpr float DRAG = 0.98f;
+        static constexpr bool GROWS = true;
+        static constexpr ParticleShape SHAPE = ParticleShape::Circle;
+        static constexpr int COUNT = 20;
+        static constexpr bool AIMED = false;
+        static constexpr float AIM = 0.0f;
+        static constexpr float SPREAD = PI;
+        static constexpr Range SPEED = { 50.0f, 200.0f };
+        static constexpr Range SIZE = { 2.0f, 8.0f };
+        static constexpr Range LIFETIME = { 0.5f, 2.0f };
+        static constexpr Rgb COLORS[] = { { 255, 0, 0 }, { 255, 255, 0 }, { 255, 165, 0 }, { 255, 255, 255 } }; // Red, yellow, orange, white
+        static constexpr Rgb COLOR_JITTER = { 0, 0, 0 };
+    };
+    
+    template <> struct ParticleTraits<ParticleType::Laser> {
+        static constexpr const char* NAME = "Laser";
+        static constexpr int PRIORITY = 2;
+        static constexpr float QUOTA = 0.2f;
+        static constexpr float GRAVITY = 0.0f;
+        static constexpr float DRAG = 0.95f; // Light air resistance
+        static constexpr bool GROWS = false;
+        static constexpr ParticleShape SHAPE = ParticleShape::Streak;
+        static constexpr int COUNT = 8;
+        static constexpr bool AIMED = false;
+        static constexpr float AIM = 0.0f;
+        static constexpr float SPREAD = PI;
+        static constexpr Range SPEED = { 20.0f, 80.0f };
+        static constexpr Range SIZE = { 1.0f, 4.0f };
+        static constexpr Range LIFETIME = { 0.8f, 0.8f };
+        static constexpr Rgb COLORS[] = { { 255, 50, 0 } };
+        static constexpr Rgb COLOR_JITTER = { 0, 99, 0 };
+    };
+    
+    template <> struct ParticleTraits<ParticleType::Punch> {
+        static constexpr const char* NAME = "Punch";
+        static constexpr int PRIORITY = 3;
+        static constexpr float QUOTA = 0.2f;
+        static constexpr float GRAVITY = 150.0f;
+        static constexpr float DRAG = 0.98f;
+        static constexpr bool GROWS = false;
+        static constexpr ParticleShape SHAPE = ParticleShape::Circle;
+        static constexpr int COUNT = 15;
+        static constexpr bool AIMED = false;
+        static constexpr float AIM = 0.0f;
+        static constexpr float SPREAD = PI;
+        static constexpr Range SPEED = { 100.0f, 300.0f };
+        static constexpr Range SIZE = { 3.0f, 10.0f };
+        static constexpr Range LIFETIME = { 1.2f, 1.2f };
+        static constexpr Rgb COLORS[] = { { 200, 255, 0 } };
+        static constexpr Rgb COLOR_JITTER = { 54, 0, 0 };
+    };
+    
+    template <> struct ParticleTraits<ParticleType::Damage> {
+        static constexpr const char* NAME = "Damage";
+        static constexpr int PRIORITY = 3;
+        static constexpr float QUOTA = 0.2f;
+        static constexpr float GRAVITY = 150.0f;
+        static constexpr float DRAG = 0.98f;
+        static constexpr bool GROWS = false;
+        static constexpr ParticleShape SHAPE = ParticleShape::Circle;
+        static constexpr int COUNT = 10;
+        static constexpr bool AIMED = false;
+        static constexpr float AIM = -PI / 2;
+        static constexpr float SPREAD = PI / 4; // Upward spray
+        static constexpr Range SPEED = { 30.0f, 120.0f };
+        static constexpr Range SIZE = { 2.0f, 6.0f };
+        static constexpr Range LIFETIME = { 1.5f, 1.5f };
+        static constexpr Rgb COLORS[] = { { 255, 0, 0 } };
+        static constexpr Rgb COLOR_JITTER = { 0, 0, 0 };
+    };
+    
+    template <> struct ParticleTraits<ParticleType::LevelComplete> {
+        static constexpr const char* NAME = "LevelComplete";
+        static constexpr int PRIORITY = 1;
+        static constexpr float QUOTA = 0.3f;
+        static constexpr float GRAVITY = 80.0f; // Light gravity
+        static constexpr float DRAG = 0.99f;
+        static constexpr bool GROWS = false;
+        static constexpr ParticleShape SHAPE = ParticleShape::Circle;
+        static constexpr int COUNT = 50;
+        static constexpr bool AIMED = false;
+        static constexpr float AIM = 0.0f;
+        static constexpr float SPREAD = PI;
+        static constexpr Range SPEED = { 80.0f, 250.0f };
+        static constexpr Range SIZE = { 4.0f, 12.0f };
+        static constexpr Range LIFETIME = { 2.0f, 4.0f };
+        static constexpr Rgb COLORS[] = { { 255, 255, 0 }, { 0, 255, 255 }, { 255, 0, 255 }, { 0, 255, 0 }, { 255, 255, 255 } }; // Festive colors
+        static constexpr Rgb COLOR_JITTER = { 0, 0, 0 };
+    };
+    
+    template <> struct ParticleTraits<ParticleType::Smoke> {
+        static constexpr const char* NAME = "Smoke";
+        static constexpr int PRIORITY = 0;
+        static constexpr float QUOTA = 0.3f;
+        static constexpr float GRAVITY = -20.0f; // Buoyancy, slow drift
+        static constexpr float DRAG = 0.99f;
+        static constexpr bool GROWS = true;
+        static constexpr ParticleShape SHAPE = ParticleShape::Circle;
+        static constexpr int COUNT = 12;
+        static constexpr bool AIMED = false;
+        static constexpr float AIM = -PI / 2;
+        static constexpr float SPREAD = PI / 6; // Mostly upward
+        static constexpr Range SPEED = { 10.0f, 50.0f };
+        static constexpr Range SIZE = { 5.0f, 15.0f };
+        static constexpr Range LIFETIME = { 3.0f, 3.0f };
+        static constexpr Rgb COLORS[] = { { 128, 128, 128 } };
+        static constexpr Rgb COLOR_JITTER = { 0, 0, 0 };
+    };
+    
+    template <> struct ParticleTraits<ParticleType::Spark> {
+        static constexpr const char* NAME = "Spark";
+        static constexpr int PRIORITY = 1;
+        static constexpr float QUOTA = 0.2f;
+        static constexpr float GRAVITY = 0.0f;
+        static constexpr float DRAG = 0.95f;
+        static constexpr bool GROWS = false;
+        static constexpr ParticleShape SHAPE = ParticleShape::Streak;
+        static constexpr int COUNT = 6;
+        static constexpr bool AIMED = true;
+        static constexpr float AIM = 0.0f;
+        static constexpr float SPREAD = 0.5f; // Small spread around the direction
+        static constexpr Range SPEED = { 100.0f, 300.0f };
+        static constexpr Range SIZE = { 1.0f, 3.0f };
+        static constexpr Range LIFETIME = { 0.5f, 0.5f };
+        static constexpr Rgb COLORS[] = { { 255, 200, 0 } };
+        static constexpr Rgb COLOR_JITTER = { 0, 54, 0 };
+    };
+    
+    template <typename Visitor, std::size_t... Types>
+    void forEachType(Visitor&& visitor, std::index_sequence<Types...>) {
+        (visitor(std::integral_constant<ParticleType, static_cast<ParticleType>(Types)>()), ...);
+    }
+    
+    // Calls visitor(std::integral_constant<ParticleType, T>) for every type, in enum order
+    template <typename Visitor>
+    void forEachType(Visitor&& visitor) {
+        forEachType(visitor, std::make_index_sequence<PARTICLE_TYPE_COUNT>());
+    }
+    
+    // The same for one type known only at run time
+    template <typename Visitor>
+    void visitType(ParticleType type, Visitor&& visitor) {
+        forEachType([&](auto kind) {
+            if (decltype(kind)::value == type) {
+                visitor(kind);
+            }
+        });
+    }
+    
+    // Smoke and explosions grow 1% per frame at the original 60 FPS
+    const float GROWTH_RATE = 60.0f * 0.00995f;
+    
+    // Continuous effects emit a burst 10 times per second
+    const float CONTINUOUS_SPAWN_SECONDS = 0.1f;
+    
+    // Random numbers each spawned particle takes from the stream
+    const std::uint32_t RANDOM_DRAWS = 6;
 }
 
-ParticleSystem::~ParticleSystem() = default;
+ParticleSystem::ParticleSystem(TimingWheel& timers)
+    : budget(PARTICLE_TYPE_COUNT)
+    , emissionScale(1.0f)
+    , currentEmitter(NO_EMITTER)
+    , randomSeed(std::random_device()())
+    , randomCounter(0)
+    , timers(timers) {
+    forEachType([&](auto type) {
+        using Traits = ParticleTraits<decltype(type)::value>;
+        budget.setTypePolicy(static_cast<std::size_t>(decltype(type)::value), Traits::PRIORITY, Traits::QUOTA);
+    });
+    budget.setLimit(1000);
+    
+    // Enough for a full budget in one batch before anything grows
+    const std::size_t capacity = budget.getLimit();
+    spawn.request.reserve(capacity);
+    spawn.angle.reserve(capacity);
+    spawn.speed.reserve(capacity);
+    spawn.size.reserve(capacity);
+    spawn.lifetime.reserve(capacity);
+    spawn.spin.reserve(capacity);
+    spawn.color.reserve(capacity);
+}
+
+ParticleSystem::~ParticleSystem() {
+    clearContinuousEffects();
+}
 
 void ParticleSystem::update(float deltaTime) {
-    // Update all particles
-    for (auto& particle : particles) {
-        if (particle) {
-            updateParticle(*particle, deltaTime);
-        }
-    }
+    // Update all particles, one kernel per type
+    forEachType([&](auto type) { updateBucket<decltype(type)::value>(deltaTime); });
+    
+    // Emit the bursts continuous effects queued since the last update
+    emitBatch(continuousRequests);
+    continuousRequests.clear();
+}
+
+template <ParticleType Type>
+void ParticleSystem::updateBucket(float deltaTime) {
+    using Traits = ParticleTraits<Type>;
+    Bucket& bucket = buckets[static_cast<std::size_t>(Type)];
     
-    // Update continuous effects
-    updateContinuousEffects(deltaTime);
+    // Drag is per frame at the original 60 FPS; scaled to this step once per bucket
+    const float drag = std::pow(Traits::DRAG, deltaTime * 60.0f);
     
-    // Remove dead particles
-    cleanupDeadParticles();
+    // Same constants for the whole bucket and no early exit, so it runs eight at a time
+    advanceParticles(bucket.particles, Traits::GRAVITY, drag, deltaTime);
+    
+    // Then release the ones that died. Back to front, so the particle swapped into a
+    // released index has already been checked.
+    for (std::size_t i = bucket.particles.count(); i-- > 0;) {
+        if (bucket.particles.isDead(i)) {
+            releaseParticle(static_cast<std::size_t>(Type), static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+void ParticleSystem::writeSnapshot(std::vector<ParticleSnapshot>& snapshots) const {
+    // Bucket by bucket, so snapshots come out grouped by type
+    forEachType([&](auto type) { writeBucket<decltype(type)::value>(snapshots); });
 }
 
-void ParticleSystem::render(sf::RenderWindow& window) {
-    for (const auto& particle : particles) {
-        if (particle && particle->life > 0) {
-            renderParticle(*particle, window);
+template <ParticleType Type>
+void ParticleSystem::writeBucket(std::vector<ParticleSnapshot>& snapshots) const {
+    // Everything but the offset and velocity is reconstructed from the age
+    const CompactParticleArray& particles = buckets[static_cast<std::size_t>(Type)].particles;
+    for (std::size_t i = 0; i < particles.count(); ++i) {
+        const Emitter& emitter = emitters[particles.emitter[i]];
+        const float elapsed = particles.getElapsed(i);
+        
+        ParticleSnapshot snapshot;
+        snapshot.position.x = emitter.origin.x + static_cast<float>(particles.offsetX[i]) / CompactParticle::POSITION_SCALE;
+        snapshot.position.y = emitter.origin.y + static_cast<float>(particles.offsetY[i]) / CompactParticle::POSITION_SCALE;
+        CompactParticle::fromPaletteIndex(particles.color[i], snapshot.color.r, snapshot.color.g, snapshot.color.b);
+        snapshot.color.a = static_cast<sf::Uint8>(255 * (1.0f - particles.getAge(i)));
+        snapshot.size = static_cast<float>(particles.size[i]) / CompactParticle::SIZE_SCALE;
+        if (ParticleTraits<Type>::GROWS) {
+            snapshot.size *= std::exp(GROWTH_RATE * elapsed);
         }
+        snapshot.rotation = particles.spin[i] * CompactParticle::SPIN_SCALE * elapsed;
+        snapshot.type = Type;
+        snapshots.push_back(snapshot);
     }
 }
 
+void ParticleSystem::render(const std::vector<ParticleSnapshot>& snapshots, const std::vector<std::uint32_t>& visible,
+                            RenderQueue& queue) {
+    // Snapshots are grouped by type, so each run of one type goes to that type's kernel
+    const std::uint32_t* first = visible.data();
+    const std::uint32_t* end = first + visible.size();
+    while (first != end) {
+        const ParticleType type = snapshots[*first].type;
+        const std::uint32_t* last = first;
+        while (last != end && snapshots[*last].type == type) {
+            ++last;
+        }
+        visitType(type, [&](auto kind) { renderRun<decltype(kind)::value>(snapshots, first, last, queue); });
+        first = last;
+    }
+}
+
+template <ParticleType Type>
+void ParticleSystem::renderRun(const std::vector<ParticleSnapshot>& snapshots, const std::uint32_t* first,
+                               const std::uint32_t* last, RenderQueue& queue) {
+    for (; first != last; ++first) {
+        const ParticleSnapshot& particle = snapshots[*first];
+        if (ParticleTraits<Type>::SHAPE == ParticleShape::Circle) {
+            queue.submitCircle(RenderLayer::Particles, particle.position, particle.size, particle.color);
+        } else {
+            // Draw as small rectangles for laser/spark effects
+            sf::RectangleShape shape(sf::Vector2f(particle.size * 2, particle.size));
+            shape.setFillColor(particle.color);
+            shape.setOrigin(particle.size, particle.size * 0.5f);
+            shape.setPosition(particle.position);
+            shape.setRotation(particle.rotation);
+            queue.submit(RenderLayer::Particles, shape);
+        }
+    }
+}
+
+sf::FloatRect ParticleSystem::getRenderBounds(const ParticleSnapshot& snapshot) {
+    // Rotated laser/spark rectangles reach about 1.12x their size from the centre
+    const float extent = snapshot.size * 1.2f;
+    return sf::FloatRect(snapshot.position.x - extent, snapshot.position.y - extent, extent * 2, extent * 2);
+}
+
 void ParticleSystem::clear() {
-    particles.clear();
-    continuousEffects.clear();
+    budget.clear();
+    for (Bucket& bucket : buckets) {
+        bucket.particles.clear();
+        bucket.slots.clear();
+    }
+    slotEntries.assign(slotEntries.size(), SlotEntry{ NO_TYPE, 0 });
+    emitters.clear();
+    freeEmitters.clear();
+    currentEmitter = NO_EMITTER;
+    clearContinuousEffects();
 }
 
-void ParticleSystem::addExplosion(sf::Vector2f position, int particleCount) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angleDist(0, 2 * 3.14159f);
-    std::uniform_real_distribution<float> speedDist(50, 200);
-    std::uniform_real_distribution<float> sizeDist(2, 8);
-    std::uniform_real_distribution<float> lifeDist(0.5f, 2.0f);
+const char* ParticleSystem::getTypeName(ParticleType type) {
+    const char* name = "";
+    visitType(type, [&](auto kind) { name = ParticleTraits<decltype(kind)::value>::NAME; });
+    return name;
+}
+
+void ParticleSystem::emitBatch(const EffectRequest* requests, std::size_t count) {
+    // Size the whole batch first, so the spawn buffers are resized once
+    spawn.counts.resize(count);
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        visitType(requests[i].type, [&](auto type) {
+            spawn.counts[i] = static_cast<std::uint32_t>(scaleCount(ParticleTraits<decltype(type)::value>::COUNT * requests[i].intensity));
+        });
+        total += spawn.counts[i];
+    }
+    spawn.request.resize(total);
+    spawn.angle.resize(total);
+    spawn.speed.resize(total);
+    spawn.size.resize(total);
+    spawn.lifetime.resize(total);
+    spawn.spin.resize(total);
+    spawn.color.resize(total);
     
-    for (int i = 0; i < particleCount; ++i) {
-        float angle = angleDist(gen);
-        float speed = speedDist(gen);
-        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
-        
-        // Mix of orange, red, and yellow for explosion
-        sf::Color colors[] = {
-            sf::Color::Red,
-            sf::Color::Yellow,
-            sf::Color(255, 165, 0), // Orange
-            sf::Color::White
-        };
-        sf::Color color = colors[i % 4];
-        
-        addParticle(position, velocity, color, lifeDist(gen), sizeDist(gen), ParticleType::Explosion);
+    // Draw every particle's parameters, one type kernel per request
+    std::size_t first = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        visitType(requests[i].type, [&](auto type) {
+            generateSpawns<decltype(type)::value>(requests[i], static_cast<std::uint32_t>(i), first, spawn.counts[i]);
+        });
+        first += spawn.counts[i];
+    }
+    
+    // Then hand them to the budget in request order
+    for (std::size_t i = 0; i < total; ++i) {
+        const EffectRequest& request = requests[spawn.request[i]];
+        const sf::Vector2f velocity(std::cos(spawn.angle[i]) * spawn.speed[i], std::sin(spawn.angle[i]) * spawn.speed[i]);
+        addParticle(request.position, velocity, spawn.color[i], spawn.lifetime[i], spawn.size[i], spawn.spin[i], request.type);
     }
 }
 
-void ParticleSystem::addLaserEffect(sf::Vector2f position, int particleCount) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angleDist(0, 2 * 3.14159f);
-    std::uniform_real_distribution<float> speedDist(20, 80);
-    std::uniform_real_distribution<float> sizeDist(1, 4);
+template <ParticleType Type>
+void ParticleSystem::generateSpawns(const EffectRequest& request, std::uint32_t requestIndex, std::size_t first, std::size_t count) {
+    using Traits = ParticleTraits<Type>;
+    const std::size_t colorCount = sizeof(Traits::COLORS) / sizeof(Traits::COLORS[0]);
+    const float aim = Traits::AIMED ? std::atan2(request.direction.y, request.direction.x) : Traits::AIM;
     
-    for (int i = 0; i < particleCount; ++i) {
-        float angle = angleDist(gen);
-        float speed = speedDist(gen);
-        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
-        
-        sf::Color color = sf::Color::Red;
-        color.r = 255;
-        color.g = static_cast<sf::Uint8>(50 + rand() % 100);
-        color.b = 0;
+    const std::uint32_t counter = randomCounter;
+    randomCounter += static_cast<std::uint32_t>(count) * RANDOM_DRAWS;
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint32_t draw = counter + static_cast<std::uint32_t>(i) * RANDOM_DRAWS;
+        const std::size_t out = first + i;
+        spawn.request[out] = requestIndex;
+        spawn.angle[out] = aim + (randomUnit(randomSeed, draw) * 2.0f - 1.0f) * Traits::SPREAD;
+        spawn.speed[out] = Traits::SPEED.min + randomUnit(randomSeed, draw + 1) * (Traits::SPEED.max - Traits::SPEED.min);
+        spawn.size[out] = Traits::SIZE.min + randomUnit(randomSeed, draw + 2) * (Traits::SIZE.max - Traits::SIZE.min);
+        spawn.lifetime[out] = Traits::LIFETIME.min + randomUnit(randomSeed, draw + 3) * (Traits::LIFETIME.max - Traits::LIFETIME.min);
+        spawn.spin[out] = (randomUnit(randomSeed, draw + 4) * 2.0f - 1.0f) * 360.0f; // Random rotation speed
         
-        addParticle(position, velocity, color, 0.8f, sizeDist(gen), ParticleType::Laser);
+        const Rgb& color = Traits::COLORS[i % colorCount];
+        const float jitter = randomUnit(randomSeed, draw + 5);
+        spawn.color[out] = CompactParticle::toPaletteIndex(
+            static_cast<std::uint8_t>(color.r + static_cast<int>(jitter * Traits::COLOR_JITTER.r)),
+            static_cast<std::uint8_t>(color.g + static_cast<int>(jitter * Traits::COLOR_JITTER.g)),
+            static_cast<std::uint8_t>(color.b + static_cast<int>(jitter * Traits::COLOR_JITTER.b)));
     }
 }
 
+template <ParticleType Type>
+void ParticleSystem::emitEffect(sf::Vector2f position, int particleCount, sf::Vector2f direction) {
+    const EffectRequest request(position, Type, static_cast<float>(particleCount) / ParticleTraits<Type>::COUNT, direction);
+    emitBatch(&request, 1);
+}
+
+void ParticleSystem::addExplosion(sf::Vector2f position, int particleCount) {
+    emitEffect<ParticleType::Explosion>(position, particleCount);
+}
+
+void ParticleSystem::addLaserEffect(sf::Vector2f position, int particleCount) {
+    emitEffect<ParticleType::Laser>(position, particleCount);
+}
+
 void ParticleSystem::addPunchEffect(sf::Vector2f position, int particleCount) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angleDist(0, 2 * 3.14159f);
-    std::uniform_real_distribution<float> speedDist(100, 300);
-    std::uniform_real_distribution<float> sizeDist(3, 10);
-    
-    for (int i = 0; i < particleCount; ++i) {
-        float angle = angleDist(gen);
-        float speed = speedDist(gen);
-        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
-        
-        sf::Color color = sf::Color::Yellow;
-        color.g = 255;
-        color.r = static_cast<sf::Uint8>(200 + rand() % 55);
-        color.b = 0;
-        
-        addParticle(position, velocity, color, 1.2f, sizeDist(gen), ParticleType::Punch);
-    }
+    emitEffect<ParticleType::Punch>(position, particleCount);
 }
 
 void ParticleSystem::addDamageEffect(sf::Vector2f position, int particleCount) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angleDist(-3.14159f/4, 3.14159f/4); // Upward spray
-    std::uniform_real_distribution<float> speedDist(30, 120);
-    std::uniform_real_distribution<float> sizeDist(2, 6);
-    
-    for (int i = 0; i < particleCount; ++i) {
-        float angle = angleDist(gen) - 3.14159f/2; // Bias upward
-        float speed = speedDist(gen);
-        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
-        
-        sf::Color color = sf::Color::Red;
-        color.a = static_cast<sf::Uint8>(150 + rand() % 105);
-        
-        addParticle(position, velocity, color, 1.5f, sizeDist(gen), ParticleType::Damage);
-    }
+    emitEffect<ParticleType::Damage>(position, particleCount);
 }
 
 void ParticleSystem::addLevelCompleteEffect(sf::Vector2f position, int particleCount) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angleDist(0, 2 * 3.14159f);
-    std::uniform_real_distribution<float> speedDist(80, 250);
-    std::uniform_real_distribution<float> sizeDist(4, 12);
-    std::uniform_real_distribution<float> lifeDist(2.0f, 4.0f);
-    
-    for (int i = 0; i < particleCount; ++i) {
-        float angle = angleDist(gen);
-        float speed = speedDist(gen);
-        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
-        
-        // Festive colors
-        sf::Color colors[] = {
-            sf::Color::Yellow,
-            sf::Color::Cyan,
-            sf::Color::Magenta,
-            sf::Color::Green,
-            sf::Color::White
-        };
-        sf::Color color = colors[i % 5];
-        
-        addParticle(position, velocity, color, lifeDist(gen), sizeDist(gen), ParticleType::LevelComplete);
-    }
+    emitEffect<ParticleType::LevelComplete>(position, particleCount);
 }
 
 void ParticleSystem::addSmokeEffect(sf::Vector2f position, int particleCount) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angleDist(-3.14159f/6, 3.14159f/6); // Mostly upward
-    std::uniform_real_distribution<float> speedDist(10, 50);
-    std::uniform_real_distribution<float> sizeDist(5, 15);
-    
-    for (int i = 0; i < particleCount; ++i) {
-        float angle = angleDist(gen) - 3.14159f/2; // Upward
-        float speed = speedDist(gen);
-        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
-        
-        sf::Color color(128, 128, 128, 180); // Gray smoke
-        
-        addParticle(position, velocity, color, 3.0f, sizeDist(gen), ParticleType::Smoke);
-    }
+    emitEffect<ParticleType::Smoke>(position, particleCount);
 }
 
 void ParticleSystem::addSparkEffect(sf::Vector2f position, sf::Vector2f direction, int particleCount) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angleDist(-0.5f, 0.5f); // Small spread around direction
-    std::uniform_real_distribution<float> speedDist(100, 300);
-    std::uniform_real_distribution<float> sizeDist(1, 3);
-    
-    float baseAngle = std::atan2(direction.y, direction.x);
-    
-    for (int i = 0; i < particleCount; ++i) {
-        float angle = baseAngle + angleDist(gen);
-        float speed = speedDist(gen);
-        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
-        
-        sf::Color color = sf::Color::White;
-        color.r = 255;
-        color.g = static_cast<sf::Uint8>(200 + rand() % 55);
-        color.b = 0;
-        
-        addParticle(position, velocity, color, 0.5f, sizeDist(gen), ParticleType::Spark);
-    }
+    emitEffect<ParticleType::Spark>(position, particleCount, direction);
 }
 
-void ParticleSystem::addContinuousEffect(sf::Vector2f position, ParticleType type, float duration) {
-    ContinuousEffect effect;
-    effect.position = position;
-    effect.type = type;
-    effect.duration = duration;
-    effect.timer = 0;
-    effect.spawnRate = 0.1f; // 10 particles per second
-    effect.spawnTimer = 0;
-    
-    continuousEffects.push_back(effect);
+int ParticleSystem::scaleCount(float particleCount) const {
+    // Effects never disappear entirely, however low the quality
+    return std::max(1, static_cast<int>(particleCount * emissionScale + 0.5f));
 }
 
-void ParticleSystem::addParticle(sf::Vector2f position, sf::Vector2f velocity, sf::Color color, 
-                                 float lifetime, float size, ParticleType type) {
-    if (particles.size() < static_cast<size_t>(maxParticles)) {
-        particles.push_back(std::make_unique<Particle>(position, velocity, color, lifetime, size, type));
+void ParticleSystem::addContinuousEffect(sf::Vector2f position, ParticleType type, float duration) {
+    std::uint32_t index;
+    if (!freeContinuousEffects.empty()) {
+        index = freeContinuousEffects.back();
+        freeContinuousEffects.pop_back();
+    } else {
+        index = static_cast<std::uint32_t>(continuousEffects.size());
+        continuousEffects.push_back(ContinuousEffect());
     }
+    
+    ContinuousEffect& effect = continuousEffects[index];
+    effect.position = position;
+    effect.type = type;
+    effect.spawnTimer = timers.schedule(CONTINUOUS_SPAWN_SECONDS, [this, index] { spawnContinuousEffect(index); },
+                                        CONTINUOUS_SPAWN_SECONDS);
+    effect.endTimer = timers.schedule(duration, [this, index] { endContinuousEffect(index); });
 }
 
-void ParticleSystem::updateParticle(Particle& particle, float deltaTime) {
-    // Update life
-    particle.life -= deltaTime;
-    
-    if (particle.life <= 0) return;
-    
-    // Update position
-    particle.position += particle.velocity * deltaTime;
-    
-    // Update rotation
-    particle.rotation += particle.rotationSpeed * deltaTime;
-    
-    // Apply gravity and air resistance based on particle type
-    switch (particle.type) {
-        case ParticleType::Explosion:
-        case ParticleType::Punch:
-        case ParticleType::Damage:
-            particle.velocity.y += 150.0f * deltaTime; // Gravity
-            particle.velocity *= 0.98f; // Air resistance
+void ParticleSystem::spawnContinuousEffect(std::uint32_t index) {
+    const ContinuousEffect& effect = continuousEffects[index];
+    switch (effect.type) {
+        case ParticleType::Smoke:
+            continuousRequests.push_back(EffectRequest(effect.position, ParticleType::Smoke,
+                                                       2.0f / ParticleTraits<ParticleType::Smoke>::COUNT));
             break;
-            
-        case ParticleType::Laser:
         case ParticleType::Spark:
-            particle.velocity *= 0.95f; // Light air resistance
-            break;
-            
-        case ParticleType::Smoke:
-            particle.velocity.y -= 20.0f * deltaTime; // Buoyancy
-            particle.velocity *= 0.99f; // Slow drift
+            continuousRequests.push_back(EffectRequest(effect.position, ParticleType::Spark,
+                                                       1.0f / ParticleTraits<ParticleType::Spark>::COUNT, sf::Vector2f(0, -1)));
             break;
-            
-        case ParticleType::LevelComplete:
-            particle.velocity.y += 80.0f * deltaTime; // Light gravity
-            particle.velocity *= 0.99f;
+        // Add other continuous effects as needed
+        default:
             break;
     }
-    
-    // Update alpha based on remaining life
-    float lifePercent = particle.life / particle.maxLife;
-    sf::Uint8 alpha = static_cast<sf::Uint8>(255 * lifePercent);
-    particle.color.a = alpha;
-    
-    // Scale down over time for some particle types
-    if (particle.type == ParticleType::Smoke || particle.type == ParticleType::Explosion) {
-        particle.size *= 1.01f; // Grow slightly
+}
+
+void ParticleSystem::endContinuousEffect(std::uint32_t index) {
+    ContinuousEffect& effect = continuousEffects[index];
+    timers.cancel(effect.spawnTimer);
+    timers.cancel(effect.endTimer);
+    freeContinuousEffects.push_back(index);
+}
+
+void ParticleSystem::clearContinuousEffects() {
+    for (ContinuousEffect& effect : continuousEffects) {
+        timers.cancel(effect.spawnTimer);
+        timers.cancel(effect.endTimer);
     }
+    continuousEffects.clear();
+    freeContinuousEffects.clear();
+    continuousRequests.clear();
 }
 
-void ParticleSystem::renderParticle(const Particle& particle, sf::RenderWindow& window) {
-    if (particle.life <= 0) return;
-    
-    switch (particle.type) {
-        case ParticleType::Explosion:
-        case ParticleType::Punch:
-        case ParticleType::Damage:
-        case ParticleType::LevelComplete: {
-            sf::CircleShape shape(particle.size);
-            shape.setFillColor(particle.color);
-            shape.setOrigin(particle.size, particle.size);
-            shape.setPosition(particle.position);
-            window.draw(shape);
-            break;
-        }
-        
-        case ParticleType::Laser:
-        case ParticleType::Spark: {
-            // Draw as small rectangles for laser/spark effects
-            sf::RectangleShape shape(sf::Vector2f(particle.size * 2, particle.size));
-            shape.setFillColor(particle.color);
-            shape.setOrigin(particle.size, particle.size * 0.5f);
-            shape.setPosition(particle.position);
-            shape.setRotation(particle.rotation);
-            window.draw(shape);
-            break;
-        }
-        
-        case ParticleType::Smoke: {
-            // Draw smoke as semi-transparent circles that grow
-            sf::CircleShape shape(particle.size);
-            shape.setFillColor(particle.color);
-            shape.setOrigin(particle.size, particle.size);
-            shape.setPosition(particle.position);
-            window.draw(shape);
-            break;
-        }
+void ParticleSystem::addParticle(sf::Vector2f position, sf::Vector2f velocity, std::uint8_t color,
+                                 float lifetime, float size, float rotationSpeed, ParticleType type) {
+    // The budget may hand back the slot of an evicted particle
+    const std::int32_t slot = budget.allocate(static_cast<std::size_t>(type));
+    if (slot == ParticleBudget::NO_SLOT) {
+        return;
+    }
+    if (static_cast<std::size_t>(slot) >= slotEntries.size()) {
+        slotEntries.resize(slot + 1, SlotEntry{ NO_TYPE, 0 });
+    }
+    const SlotEntry evicted = slotEntries[slot];
+    if (evicted.type != NO_TYPE) {
+        releaseEmitter(buckets[evicted.type].particles.emitter[evicted.index]);
+        removeFromBucket(evicted.type, evicted.index);
     }
+    
+    CompactParticle particle;
+    particle.offsetX = 0;
+    particle.offsetY = 0;
+    particle.velocityX = velocity.x;
+    particle.velocityY = velocity.y;
+    particle.age = 0;
+    particle.emitter = acquireEmitter(position, type);
+    particle.lifetime = static_cast<std::uint8_t>(std::max(1.0f, std::min(255.0f, lifetime * CompactParticle::LIFETIME_SCALE + 0.5f)));
+    particle.color = color;
+    particle.size = static_cast<std::uint8_t>(std::max(1.0f, std::min(255.0f, size * CompactParticle::SIZE_SCALE + 0.5f)));
+    particle.spin = static_cast<std::int8_t>(std::max(-128.0f, std::min(127.0f, std::round(rotationSpeed / CompactParticle::SPIN_SCALE))));
+    
+    Bucket& bucket = buckets[static_cast<std::size_t>(type)];
+    slotEntries[slot] = SlotEntry{ static_cast<std::uint16_t>(type), static_cast<std::uint32_t>(bucket.particles.count()) };
+    bucket.particles.add(particle);
+    bucket.slots.push_back(slot);
 }
 
-void ParticleSystem::cleanupDeadParticles() {
-    particles.erase(
-        std::remove_if(particles.begin(), particles.end(),
-            [](const std::unique_ptr<Particle>& particle) {
-                return !particle || particle->life <= 0;
-            }),
-        particles.end()
-    );
+void ParticleSystem::releaseParticle(std::size_t type, std::uint32_t index) {
+    Bucket& bucket = buckets[type];
+    const std::int32_t slot = bucket.slots[index];
+    releaseEmitter(bucket.particles.emitter[index]);
+    slotEntries[slot].type = NO_TYPE;
+    budget.release(slot);
+    removeFromBucket(type, index);
 }
 
-void ParticleSystem::updateContinuousEffects(float deltaTime) {
-    for (auto it = continuousEffects.begin(); it != continuousEffects.end();) {
-        it->timer += deltaTime;
-        it->spawnTimer += deltaTime;
-        
-        // Spawn particles at regular intervals
-        if (it->spawnTimer >= it->spawnRate) {
-            switch (it->type) {
-                case ParticleType::Smoke:
-                    addSmokeEffect(it->position, 2);
-                    break;
-                case ParticleType::Spark:
-                    addSparkEffect(it->position, sf::Vector2f(0, -1), 1);
-                    break;
-                // Add other continuous effects as needed
-                default:
-                    break;
-            }
-            it->spawnTimer = 0;
-        }
-        
-        // Remove expired effects
-        if (it->timer >= it->duration) {
-            it = continuousEffects.erase(it);
-        } else {
-            ++it;
-        }
+void ParticleSystem::removeFromBucket(std::size_t type, std::uint32_t index) {
+    // Swap with the last particle to keep the bucket packed
+    Bucket& bucket = buckets[type];
+    const std::uint32_t last = static_cast<std::uint32_t>(bucket.particles.count() - 1);
+    if (index != last) {
+        bucket.slots[index] = bucket.slots[last];
+        slotEntries[bucket.slots[index]].index = index;
     }
+    bucket.particles.remove(index);
+    bucket.slots.pop_back();
 }
 
-sf::Vector2f ParticleSystem::getRandomVelocity(float minSpeed, float maxSpeed) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angleDist(0, 2 * 3.14159f);
-    std::uniform_real_distribution<float> speedDist(minSpeed, maxSpeed);
-    
-    float angle = angleDist(gen);
-    float speed = speedDist(gen);
+std::uint16_t ParticleSystem::acquireEmitter(sf::Vector2f origin, ParticleType type) {
+    // Every particle of one effect call shares the emitter opened by its first particle
+    if (currentEmitter != NO_EMITTER) {
+        Emitter& current = emitters[currentEmitter];
+        if (current.particleCount > 0 && current.type == type && current.origin == origin) {
+            ++current.particleCount;
+            return currentEmitter;
+        }
+    }
     
-    return sf::Vector2f(std::cos(angle) * speed, std::sin(angle) * speed);
+    if (!freeEmitters.empty()) {
+        currentEmitter = freeEmitters.back();
+        freeEmitters.pop_back();
+    } else {
+        currentEmitter = static_cast<std::uint16_t>(emitters.size());
+        emitters.push_back(Emitter());
+    }
+    emitters[currentEmitter] = Emitter{ origin, type, 1 };
+    return currentEmitter;
 }
 
-sf::Color ParticleSystem::getRandomColor(sf::Color baseColor, int variance) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> colorDist(-variance, variance);
-    
-    int r = std::max(0, std::min(255, static_cast<int>(baseColor.r) + colorDist(gen)));
-    int g = std::max(0, std::min(255, static_cast<int>(baseColor.g) + colorDist(gen)));
-    int b = std::max(0, std::min(255, static_cast<int>(baseColor.b) + colorDist(gen)));
-    
-    return sf::Color(static_cast<sf::Uint8>(r), static_cast<sf::Uint8>(g), static_cast<sf::Uint8>(b), baseColor.a);
-}
\ No newline at end of file
+void ParticleSystem::releaseEmitter(std::uint16_t emitter) {
+    if (--emitters[emitter].particleCount == 0) {
+        freeEmitters.push_back(emitter);
+    }
+}
@@ -2,7 +2,13 @@
 
 #include <SFML/Graphics.hpp>
 #include <vector>
-#include <memory>
+#include <cstdint>
+#include "ParticleBudget.h"
+#include "CompactParticle.h"
+#include "TimingWheel.h"
+
+struct ParticleSnapshot;
+class RenderQueue;
 
 enum class ParticleType {
     Explosion,
@@ -14,39 +20,39 @@ enum class ParticleType {
     Spark
 };
 
-struct Particle {
+const std::size_t PARTICLE_TYPE_COUNT = 7;
+
+// One effect asked for during a tick, emitted later with the rest of the batch
+struct EffectRequest {
     sf::Vector2f position;
-    sf::Vector2f velocity;
-    sf::Color color;
-    float life;
-    float maxLife;
-    float size;
-    float rotation;
-    float rotationSpeed;
     ParticleType type;
+    float intensity;         // Multiplies the type's default particle count
+    sf::Vector2f direction;  // Sparks fly along it; ignored by the other types
     
-    Particle(sf::Vector2f pos, sf::Vector2f vel, sf::Color col, float lifetime, float particleSize, ParticleType particleType)
-        : position(pos)
-        , velocity(vel)
-        , color(col)
-        , life(lifetime)
-        , maxLife(lifetime)
-        , size(particleSize)
-        , rotation(0)
-        , rotationSpeed((rand() % 360 - 180) * 2.0f) // Random rotation speed
-        , type(particleType) {}
+    EffectRequest(sf::Vector2f position, ParticleType type, float intensity = 1.0f,
+                  sf::Vector2f direction = sf::Vector2f())
+        : position(position), type(type), intensity(intensity), direction(direction) {}
 };
 
 class ParticleSystem {
 public:
-    ParticleSystem();
+    explicit ParticleSystem(TimingWheel& timers);
     ~ParticleSystem();
     
     void update(float deltaTime);
-    void render(sf::RenderWindow& window);
     void clear();
     
-    // Effect creation methods
+    // Rendering works from snapshots so it can run on the render thread
+    void writeSnapshot(std::vector<ParticleSnapshot>& snapshots) const;
+    static void render(const std::vector<ParticleSnapshot>& snapshots, const std::vector<std::uint32_t>& visible,
+                       RenderQueue& queue);
+    static sf::FloatRect getRenderBounds(const ParticleSnapshot& snapshot);
+    
+    // Emits a tick's worth of effects in one pass, drawing from the system's random stream
+    void emitBatch(const EffectRequest* requests, std::size_t count);
+    void emitBatch(const std::vector<EffectRequest>& requests) { emitBatch(requests.data(), requests.size()); }
+    
+    // Effect creation methods, each a batch of one
     void addExplosion(sf::Vector2f position, int particleCount = 20);
     void addLaserEffect(sf::Vector2f position, int particleCount = 8);
     void addPunchEffect(sf::Vector2f position, int particleCount = 15);
@@ -59,34 +65,98 @@ public:
     void addContinuousEffect(sf::Vector2f position, ParticleType type, float duration);
     
     // System management
-    int getParticleCount() const { return static_cast<int>(particles.size()); }
-    void setMaxParticles(int maxCount) { maxParticles = maxCount; }
+    int getParticleCount() const { return static_cast<int>(budget.getLiveCount()); }
+    void setMaxParticles(int maxCount) { budget.setLimit(static_cast<std::size_t>(maxCount)); }
+    // Scales the particle count of every effect added afterwards
+    void setEmissionScale(float scale) { emissionScale = scale; }
+    
+    // Budget statistics per particle type
+    const ParticleTypeStats& getTypeStats(ParticleType type) const { return budget.getStats(static_cast<std::size_t>(type)); }
+    static const char* getTypeName(ParticleType type);
     
 private:
-    std::vector<std::unique_ptr<Particle>> particles;
-    int maxParticles;
+    // Origin and type shared by the particles of one effect
+    struct Emitter {
+        sf::Vector2f origin;
+        ParticleType type;
+        std::uint32_t particleCount; // Free when zero
+    };
+    
+    // One bucket per type, packed: every kernel runs over particles of a single type
+    struct Bucket {
+        CompactParticleArray particles;
+        std::vector<std::int32_t> slots; // Budget slot of each particle
+    };
+    
+    // Where the particle in a budget slot lives
+    struct SlotEntry {
+        std::uint16_t type; // NO_TYPE when the slot is free
+        std::uint32_t index;
+    };
+    
+    static const std::uint16_t NO_EMITTER = 0xFFFF;
+    static const std::uint16_t NO_TYPE = 0xFFFF;
+    
+    Bucket buckets[PARTICLE_TYPE_COUNT];
+    std::vector<SlotEntry> slotEntries; // Indexed by budget slot
+    ParticleBudget budget;
+    float emissionScale;
+    
+    std::vector<Emitter> emitters;
+    std::vector<std::uint16_t> freeEmitters;
+    std::uint16_t currentEmitter;
     
     // Helper methods
-    void addParticle(sf::Vector2f position, sf::Vector2f velocity, sf::Color color, 
-                     float lifetime, float size, ParticleType type);
-    void updateParticle(Particle& particle, float deltaTime);
-    void renderParticle(const Particle& particle, sf::RenderWindow& window);
+    void addParticle(sf::Vector2f position, sf::Vector2f velocity, std::uint8_t color,
+                     float lifetime, float size, float rotationSpeed, ParticleType type);
+    void releaseParticle(std::size_t type, std::uint32_t index);
+    void removeFromBucket(std::size_t type, std::uint32_t index);
+    std::uint16_t acquireEmitter(sf::Vector2f origin, ParticleType type);
+    void releaseEmitter(std::uint16_t emitter);
+    
+    // Kernels, instantiated once per type from its ParticleTraits
+    template <ParticleType Type> void updateBucket(float deltaTime);
+    template <ParticleType Type> void writeBucket(std::vector<ParticleSnapshot>& snapshots) const;
+    template <ParticleType Type>
+    static void renderRun(const std::vector<ParticleSnapshot>& snapshots, const std::uint32_t* first,
+                          const std::uint32_t* last, RenderQueue& queue);
+    
+    // Spawn parameters for a batch, one entry per particle, reused between batches
+    struct SpawnBuffer {
+        std::vector<std::uint32_t> counts; // Per request
+        std::vector<std::uint32_t> request;
+        std::vector<float> angle;
+        std::vector<float> speed;
+        std::vector<float> size;
+        std::vector<float> lifetime;
+        std::vector<float> spin;
+        std::vector<std::uint8_t> color;
+    };
+    
+    SpawnBuffer spawn;
+    std::uint32_t randomSeed;
+    std::uint32_t randomCounter; // Position in the random stream
     
-    // Effect-specific helpers
-    sf::Vector2f getRandomVelocity(float minSpeed, float maxSpeed);
-    sf::Color getRandomColor(sf::Color baseColor, int variance = 50);
-    void cleanupDeadParticles();
+    template <ParticleType Type>
+    void generateSpawns(const EffectRequest& request, std::uint32_t requestIndex, std::size_t first, std::size_t count);
+    template <ParticleType Type>
+    void emitEffect(sf::Vector2f position, int particleCount, sf::Vector2f direction = sf::Vector2f());
+    int scaleCount(float particleCount) const;
     
-    // Continuous effect data
+    // Continuous effects run on the game's timing wheel: a repeating timer queues each
+    // burst and a one-shot timer ends the effect. Slots are reused through a free list.
     struct ContinuousEffect {
         sf::Vector2f position;
         ParticleType type;
-        float duration;
-        float timer;
-        float spawnRate;
-        float spawnTimer;
+        TimerHandle spawnTimer;
+        TimerHandle endTimer; // Pending while the slot is in use
     };
     
+    TimingWheel& timers;
     std::vector<ContinuousEffect> continuousEffects;
-    void updateContinuousEffects(float deltaTime);
+    std::vector<std::uint32_t> freeContinuousEffects;
+    std::vector<EffectRequest> continuousRequests; // Queued by spawn timers, emitted by update()
+    void spawnContinuousEffect(std::uint32_t index);
+    void endContinuousEffect(std::uint32_t index);
+    void clearContinuousEffects();
 };
\ No newline at end of file
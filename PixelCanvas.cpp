@@ -0,0 +1,119 @@
+#include "PixelCanvas.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PIXELCANVAS_SSE2 1
+#endif
+
+PixelCanvas::PixelCanvas()
+    : width(0)
+    , height(0) {
+}
+
+PixelCanvas::PixelCanvas(unsigned int canvasWidth, unsigned int canvasHeight, sf::Color clearColor)
+    : width(0)
+    , height(0) {
+    create(canvasWidth, canvasHeight, clearColor);
+}
+
+void PixelCanvas::create(unsigned int canvasWidth, unsigned int canvasHeight, sf::Color clearColor) {
+    width = canvasWidth;
+    height = canvasHeight;
+    pixels.assign(static_cast<std::size_t>(width) * height, pack(clearColor));
+}
+
+std::uint32_t PixelCanvas::pack(sf::Color color) {
+    const sf::Uint8 bytes[4] = { color.r, color.g, color.b, color.a };
+    std::uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+void PixelCanvas::fill(std::uint32_t* destination, std::size_t count, std::uint32_t value) {
+#ifdef PIXELCANVAS_SSE2
+    const __m128i packed = _mm_set1_epi32(static_cast<int>(value));
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), packed);
+    }
+    for (; i < count; ++i) {
+        destination[i] = value;
+    }
+#else
+    std::fill_n(destination, count, value);
+#endif
+}
+
+void PixelCanvas::fillRect(int left, int top, int rectWidth, int rectHeight, sf::Color color) {
+    const int x0 = std::max(left, 0);
+    const int x1 = std::min(left + rectWidth, static_cast<int>(width));
+    const int y0 = std::max(top, 0);
+    const int y1 = std::min(top + rectHeight, static_cast<int>(height));
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    const std::uint32_t value = pack(color);
+    for (int y = y0; y < y1; ++y) {
+        fill(row(static_cast<unsigned int>(y)) + x0, static_cast<std::size_t>(x1 - x0), value);
+    }
+}
+
+void PixelCanvas::fillCircle(int centerX, int centerY, int radiusSquared, sf::Color color) {
+    fillCircle(centerX, centerY, radiusSquared, color,
+               sf::IntRect(0, 0, static_cast<int>(width), static_cast<int>(height)));
+}
+
+void PixelCanvas::fillCircle(int centerX, int centerY, int radiusSquared, sf::Color color, const sf::IntRect& clip) {
+    if (radiusSquared <= 0) {
+        return;
+    }
+
+    const int clipLeft = std::max(clip.left, 0);
+    const int clipRight = std::min(clip.left + clip.width, static_cast<int>(width));
+    const int clipTop = std::max(clip.top, 0);
+    const int clipBottom = std::min(clip.top + clip.height, static_cast<int>(height));
+    const std::uint32_t value = pack(color);
+
+    // One square root per row: the row covers |dx| <= halfWidth with dx*dx < radiusSquared - dy*dy
+    const int radius = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(radiusSquared))));
+    const int y0 = std::max(centerY - radius, clipTop);
+    const int y1 = std::min(centerY + radius + 1, clipBottom);
+
+    for (int y = y0; y < y1; ++y) {
+        const int dy = y - centerY;
+        const int remaining = radiusSquared - dy * dy;
+        if (remaining <= 0) {
+            continue;
+        }
+
+        int halfWidth = static_cast<int>(std::sqrt(static_cast<float>(remaining)));
+        // Correct float rounding so the span matches the integer test exactly
+        while (halfWidth * halfWidth >= remaining) {
+            --halfWidth;
+        }
+        while ((halfWidth + 1) * (halfWidth + 1) < remaining) {
+            ++halfWidth;
+        }
+
+        const int x0 = std::max(centerX - halfWidth, clipLeft);
+        const int x1 = std::min(centerX + halfWidth + 1, clipRight);
+        if (x0 < x1) {
+            fill(row(static_cast<unsigned int>(y)) + x0, static_cast<std::size_t>(x1 - x0), value);
+        }
+    }
+}
+
+bool PixelCanvas::copyToTexture(sf::Texture& texture) const {
+    if (width == 0 || height == 0) {
+        return false;
+    }
+    if (texture.getSize() != sf::Vector2u(width, height) && !texture.create(width, height)) {
+        return false;
+    }
+    texture.update(getPixelsPtr());
+    return true;
+}
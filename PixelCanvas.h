@@ -0,0 +1,44 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+// Raw RGBA pixel buffer used by the procedural texture generators.
+//
+// Shapes are written in whole spans (SSE2 when available) rather than pixel by
+// pixel. All drawing is clipped to the canvas.
+class PixelCanvas {
+public:
+    PixelCanvas();
+    PixelCanvas(unsigned int width, unsigned int height, sf::Color clearColor = sf::Color::Transparent);
+
+    void create(unsigned int width, unsigned int height, sf::Color clearColor = sf::Color::Transparent);
+
+    // Drawing
+    void fillRect(int left, int top, int width, int height, sf::Color color);
+    // Fills pixels with dx*dx + dy*dy < radiusSquared that also lie inside clip
+    void fillCircle(int centerX, int centerY, int radiusSquared, sf::Color color, const sf::IntRect& clip);
+    void fillCircle(int centerX, int centerY, int radiusSquared, sf::Color color);
+
+    // Direct row access for generators that compute whole rows themselves
+    std::uint32_t* row(unsigned int y) { return &pixels[static_cast<std::size_t>(y) * width]; }
+
+    // Upload
+    bool copyToTexture(sf::Texture& texture) const;
+
+    unsigned int getWidth() const { return width; }
+    unsigned int getHeight() const { return height; }
+    const sf::Uint8* getPixelsPtr() const { return reinterpret_cast<const sf::Uint8*>(pixels.data()); }
+    std::size_t getByteSize() const { return pixels.size() * sizeof(std::uint32_t); }
+
+    // Packs a color into the in-memory RGBA byte order of a pixel
+    static std::uint32_t pack(sf::Color color);
+
+private:
+    unsigned int width;
+    unsigned int height;
+    std::vector<std::uint32_t> pixels;
+
+    static void fill(std::uint32_t* destination, std::size_t count, std::uint32_t value);
+};
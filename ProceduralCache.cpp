@@ -0,0 +1,180 @@
+#include "ProceduralCache.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+const std::uint32_t ProceduralCache::MAGIC = 0x43505653; // "SVPC"
+const std::uint32_t ProceduralCache::VERSION = 1;
+
+ProceduralCache::Key::Key(const std::string& id)
+    : generatorId(id)
+    , hash(14695981039346656037ull) {
+    mix(id.data(), id.size());
+}
+
+ProceduralCache::Key& ProceduralCache::Key::add(std::uint64_t value) {
+    mix(&value, sizeof(value));
+    return *this;
+}
+
+ProceduralCache::Key& ProceduralCache::Key::add(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    mix(&bits, sizeof(bits));
+    return *this;
+}
+
+void ProceduralCache::Key::mix(const void* data, std::size_t size) {
+    // FNV-1a, 64 bit
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+ProceduralCache::ProceduralCache(const std::string& cacheDirectory)
+    : directory(cacheDirectory)
+    , enabled(true) {
+}
+
+bool ProceduralCache::loadPixels(const Key& key, unsigned int& width, unsigned int& height,
+                                 std::vector<sf::Uint8>& pixels) const {
+    std::ifstream file;
+    FileHeader header;
+    if (!openEntry(key, "rgba", file, header) ||
+        header.payloadSize != static_cast<std::uint64_t>(header.width) * header.height * 4) {
+        return false;
+    }
+
+    pixels.resize(static_cast<std::size_t>(header.payloadSize));
+    if (!file.read(reinterpret_cast<char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()))) {
+        pixels.clear();
+        return false;
+    }
+
+    width = header.width;
+    height = header.height;
+    return true;
+}
+
+bool ProceduralCache::storePixels(const Key& key, unsigned int width, unsigned int height,
+                                  const sf::Uint8* pixels) const {
+    if (!pixels) {
+        return false;
+    }
+
+    FileHeader header = {};
+    header.width = width;
+    header.height = height;
+    header.payloadSize = static_cast<std::uint64_t>(width) * height * 4;
+    return writeEntry(key, "rgba", header, pixels);
+}
+
+bool ProceduralCache::loadSamples(const Key& key, unsigned int& channelCount, unsigned int& sampleRate,
+                                  std::vector<sf::Int16>& samples) const {
+    std::ifstream file;
+    FileHeader header;
+    if (!openEntry(key, "pcm", file, header) || header.width == 0 || header.height == 0 ||
+        header.payloadSize % (sizeof(sf::Int16) * header.width) != 0) {
+        return false;
+    }
+
+    samples.resize(static_cast<std::size_t>(header.payloadSize / sizeof(sf::Int16)));
+    if (!file.read(reinterpret_cast<char*>(samples.data()), static_cast<std::streamsize>(header.payloadSize))) {
+        samples.clear();
+        return false;
+    }
+
+    channelCount = header.width;
+    sampleRate = header.height;
+    return true;
+}
+
+bool ProceduralCache::storeSamples(const Key& key, unsigned int channelCount, unsigned int sampleRate,
+                                   const std::vector<sf::Int16>& samples) const {
+    FileHeader header = {};
+    header.width = channelCount;
+    header.height = sampleRate;
+    header.payloadSize = static_cast<std::uint64_t>(samples.size()) * sizeof(sf::Int16);
+    return writeEntry(key, "pcm", header, samples.data());
+}
+
+bool ProceduralCache::openEntry(const Key& key, const char* extension, std::ifstream& file,
+                                FileHeader& header) const {
+    if (!enabled) {
+        return false;
+    }
+
+    file.open(entryFilename(key, extension), std::ios::binary);
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+
+    // Anything that doesn't match exactly is stale
+    return header.magic == MAGIC && header.version == VERSION && header.key == key.getValue();
+}
+
+bool ProceduralCache::writeEntry(const Key& key, const char* extension, const FileHeader& entryHeader,
+                                 const void* payload) const {
+    if (!enabled) {
+        return false;
+    }
+
+    try {
+        std::filesystem::create_directories(directory);
+    } catch (const std::filesystem::filesystem_error&) {
+        return false;
+    }
+
+    removeStaleEntries(key);
+
+    FileHeader header = entryHeader;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.key = key.getValue();
+
+    // Write to a temporary file and rename so a crash never leaves a torn entry
+    const std::string filename = entryFilename(key, extension);
+    const std::string tempFilename = filename + ".tmp";
+    {
+        std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(static_cast<const char*>(payload), static_cast<std::streamsize>(header.payloadSize));
+        if (!file) {
+            file.close();
+            std::remove(tempFilename.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFilename, filename, error);
+    if (error) {
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::string ProceduralCache::entryFilename(const Key& key, const char* extension) const {
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key.getValue()));
+    return directory + key.getGeneratorId() + "-" + hex + "." + extension;
+}
+
+void ProceduralCache::removeStaleEntries(const Key& key) const {
+    // Older entries of the same generator can never be hit again
+    const std::string prefix = key.getGeneratorId() + "-";
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        const std::string name = it->path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) == 0) {
+            std::error_code removeError;
+            std::filesystem::remove(it->path(), removeError);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <SFML/Config.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Content-addressed disk cache for procedurally generated assets.
+//
+// Entries are keyed by generator ID, generator parameters and seed. Each entry
+// is stored as "<directory>/<generator>-<key>.<kind>": a small header followed
+// by the raw payload (RGBA pixels in .rgba files, 16-bit PCM in .pcm files).
+// An entry whose header does not match the requested key is treated as stale
+// and the caller regenerates.
+//
+// The cache holds no mutable state, so different keys may be used from
+// different threads at once.
+class ProceduralCache {
+public:
+    // Hash of everything the generated output depends on
+    class Key {
+    public:
+        explicit Key(const std::string& generatorId);
+
+        Key& add(std::uint64_t value);
+        Key& add(std::int64_t value) { return add(static_cast<std::uint64_t>(value)); }
+        Key& add(unsigned int value) { return add(static_cast<std::uint64_t>(value)); }
+        Key& add(int value) { return add(static_cast<std::int64_t>(value)); }
+        Key& add(float value);
+
+        const std::string& getGeneratorId() const { return generatorId; }
+        std::uint64_t getValue() const { return hash; }
+
+    private:
+        std::string generatorId;
+        std::uint64_t hash;
+
+        void mix(const void* data, std::size_t size);
+    };
+
+    explicit ProceduralCache(const std::string& directory);
+
+    bool loadPixels(const Key& key, unsigned int& width, unsigned int& height, std::vector<sf::Uint8>& pixels) const;
+    bool storePixels(const Key& key, unsigned int width, unsigned int height, const sf::Uint8* pixels) const;
+
+    bool loadSamples(const Key& key, unsigned int& channelCount, unsigned int& sampleRate,
+                     std::vector<sf::Int16>& samples) const;
+    bool storeSamples(const Key& key, unsigned int channelCount, unsigned int sampleRate,
+                      const std::vector<sf::Int16>& samples) const;
+
+    void setEnabled(bool enabled) { this->enabled = enabled; }
+    bool isEnabled() const { return enabled; }
+    const std::string& getDirectory() const { return directory; }
+
+private:
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t key;
+        std::uint32_t width;   // Channel count for samples
+        std::uint32_t height;  // Sample rate for samples
+        std::uint64_t payloadSize;
+    };
+
+    std::string directory;
+    bool enabled;
+
+    // Opens an entry and checks its header against key; the stream is left at the payload
+    bool openEntry(const Key& key, const char* extension, std::ifstream& file, FileHeader& header) const;
+    bool writeEntry(const Key& key, const char* extension, const FileHeader& header, const void* payload) const;
+    std::string entryFilename(const Key& key, const char* extension) const;
+    void removeStaleEntries(const Key& key) const;
+
+    static const std::uint32_t MAGIC;
+    static const std::uint32_t VERSION;
+};
@@ -1,4 +1,6 @@
 #include "Projectile.h"
+#include "RenderSnapshot.h"
+#include "RenderQueue.h"
 #include <cmath>
 #include <algorithm>
 
@@ -6,10 +8,12 @@ const float Projectile::LASER_SPEED = 500.0f;
 const float Projectile::LASER_DAMAGE = 25.0f;
 const float Projectile::LASER_SIZE = 6.0f;
 
-Projectile::Projectile(sf::Vector2f startPosition, sf::Vector2f targetPosition, ProjectileType projectileType)
+Projectile::Projectile(sf::Vector2f startPosition, sf::Vector2f targetPosition, ProjectileType projectileType,
+                       TimingWheel& timers)
     : position(startPosition)
     , type(projectileType)
     , active(true)
+    , timers(timers)
     , animationTimer(0.0f)
     , pulseFrequency(10.0f)
     , maxTrailPoints(10) {
@@ -19,9 +23,13 @@ Projectile::Projectile(sf::Vector2f startPosition, sf::Vector2f targetPosition,
     
     // Initialize trail
     trail.reserve(maxTrailPoints);
+    
+    expiryTimer = timers.schedule(maxLifetime, [this] { active = false; });
 }
 
-Projectile::~Projectile() = default;
+Projectile::~Projectile() {
+    timers.cancel(expiryTimer);
+}
 
 void Projectile::calculateDirection(sf::Vector2f startPos, sf::Vector2f targetPos) {
     direction = targetPos - startPos;
@@ -42,7 +50,6 @@ void Projectile::initializeByType() {
             size = LASER_SIZE;
             color = sf::Color::Red;
             maxLifetime = 3.0f;
-            lifetime = maxLifetime;
             break;
             
         case ProjectileType::SuperPunch:
@@ -51,7 +58,6 @@ void Projectile::initializeByType() {
             size = 12.0f;
             color = sf::Color::Yellow;
             maxLifetime = 1.0f;
-            lifetime = maxLifetime;
             break;
             
         case ProjectileType::BossAttack:
@@ -60,7 +66,6 @@ void Projectile::initializeByType() {
             size = 15.0f;
             color = sf::Color::Magenta;
             maxLifetime = 5.0f;
-            lifetime = maxLifetime;
             break;
     }
     
@@ -74,12 +79,6 @@ void Projectile::update(float deltaTime) {
     // Update position
     position += velocity * deltaTime;
     
-    // Update lifetime
-    lifetime -= deltaTime;
-    if (lifetime <= 0) {
-        active = false;
-    }
-    
     // Update animation
     animationTimer += deltaTime;
     
@@ -106,14 +105,55 @@ void Projectile::update(float deltaTime) {
     }
 }
 
-void Projectile::render(sf::RenderWindow& window) {
-    if (!active) return;
+void Projectile::writeSnapshot(ProjectileSnapshot& snapshot, std::vector<TrailPointSnapshot>& trailPoints) const {
+    snapshot.position = position;
+    snapshot.direction = direction;
+    snapshot.color = color;
+    snapshot.size = size;
+    snapshot.animationTimer = animationTimer;
+    snapshot.pulseFrequency = pulseFrequency;
+    snapshot.lifetimeFraction = timers.getSecondsLeft(expiryTimer) / maxLifetime;
+    snapshot.type = type;
+    snapshot.firstTrailPoint = static_cast<std::uint32_t>(trailPoints.size());
+    snapshot.trailPointCount = static_cast<std::uint32_t>(trail.size());
     
+    for (const auto& point : trail) {
+        trailPoints.push_back(TrailPointSnapshot{ point.position, point.alpha });
+    }
+}
+
+void Projectile::render(const ProjectileSnapshot& snapshot, const TrailPointSnapshot* trailPoints, RenderQueue& queue) {
     // Draw trail first (behind projectile)
-    drawTrail(window);
+    drawTrail(snapshot, trailPoints, queue);
     
     // Draw main projectile
-    drawLaser(window);
+    drawLaser(snapshot, queue);
+}
+
+sf::FloatRect Projectile::getRenderBounds(const ProjectileSnapshot& snapshot, const TrailPointSnapshot* trailPoints) {
+    // Widest shape per type at full pulse (1.3x): laser glow, outer punch ring, boss aura
+    float extent = snapshot.size * 1.3f;
+    switch (snapshot.type) {
+        case ProjectileType::Laser:      extent *= 2.0f; break;
+        case ProjectileType::SuperPunch: extent = extent * 2.5f + 2.0f; break;
+        case ProjectileType::BossAttack: extent *= 1.5f; break;
+    }
+    
+    float left = snapshot.position.x - extent;
+    float top = snapshot.position.y - extent;
+    float right = snapshot.position.x + extent;
+    float bottom = snapshot.position.y + extent;
+    
+    // Trail points are never larger than half the projectile size
+    const TrailPointSnapshot* trail = trailPoints + snapshot.firstTrailPoint;
+    const float trailExtent = snapshot.size * 0.5f;
+    for (std::uint32_t i = 0; i < snapshot.trailPointCount; ++i) {
+        left = std::min(left, trail[i].position.x - trailExtent);
+        top = std::min(top, trail[i].position.y - trailExtent);
+        right = std::max(right, trail[i].position.x + trailExtent);
+        bottom = std::max(bottom, trail[i].position.y + trailExtent);
+    }
+    return sf::FloatRect(left, top, right - left, bottom - top);
 }
 
 void Projectile::updateTrail(float deltaTime) {
@@ -143,17 +183,20 @@ void Projectile::updateTrail(float deltaTime) {
     }
 }
 
-void Projectile::drawLaser(sf::RenderWindow& window) {
+void Projectile::drawLaser(const ProjectileSnapshot& snapshot, RenderQueue& queue) {
+    const sf::Vector2f& position = snapshot.position;
+    const sf::Vector2f& direction = snapshot.direction;
+    
     // Calculate pulsing effect
-    float pulseIntensity = 1.0f + 0.3f * std::sin(animationTimer * pulseFrequency);
-    float currentSize = size * pulseIntensity;
+    float pulseIntensity = 1.0f + 0.3f * std::sin(snapshot.animationTimer * snapshot.pulseFrequency);
+    float currentSize = snapshot.size * pulseIntensity;
     
     // Fade based on lifetime
-    float fadeAlpha = std::min(1.0f, lifetime / maxLifetime);
-    sf::Color currentColor = color;
+    float fadeAlpha = std::min(1.0f, snapshot.lifetimeFraction);
+    sf::Color currentColor = snapshot.color;
     currentColor.a = static_cast<sf::Uint8>(255 * fadeAlpha);
     
-    switch (type) {
+    switch (snapshot.type) {
         case ProjectileType::Laser: {
             // Draw laser as elongated rectangle
             sf::RectangleShape laser(sf::Vector2f(currentSize * 3, currentSize));
@@ -165,78 +208,57 @@ void Projectile::drawLaser(sf::RenderWindow& window) {
             float angle = std::atan2(direction.y, direction.x) * 180.0f / 3.14159f;
             laser.setRotation(angle);
             
-            window.draw(laser);
+            queue.submit(RenderLayer::Projectiles, laser);
             
             // Add glow effect
-            sf::CircleShape glow(currentSize * 2);
-            glow.setFillColor(sf::Color(currentColor.r, currentColor.g, currentColor.b, 64));
-            glow.setOrigin(currentSize * 2, currentSize * 2);
-            glow.setPosition(position);
-            window.draw(glow);
+            queue.submitCircle(RenderLayer::Projectiles, position, currentSize * 2,
+                               sf::Color(currentColor.r, currentColor.g, currentColor.b, 64));
             break;
         }
         
         case ProjectileType::SuperPunch: {
             // Draw punch as expanding circle
-            sf::CircleShape punch(currentSize);
-            punch.setFillColor(currentColor);
-            punch.setOrigin(currentSize, currentSize);
-            punch.setPosition(position);
-            window.draw(punch);
+            queue.submitCircle(RenderLayer::Projectiles, position, currentSize, currentColor);
             
             // Add impact rings
             for (int i = 1; i <= 3; ++i) {
-                sf::CircleShape ring(currentSize * (1 + i * 0.5f));
-                ring.setFillColor(sf::Color::Transparent);
-                ring.setOutlineThickness(2);
-                ring.setOutlineColor(sf::Color(currentColor.r, currentColor.g, currentColor.b, 128 / i));
-                ring.setOrigin(ring.getRadius(), ring.getRadius());
-                ring.setPosition(position);
-                window.draw(ring);
+                queue.submitCircle(RenderLayer::Projectiles, position, currentSize * (1 + i * 0.5f),
+                                   sf::Color::Transparent, 2.0f,
+                                   sf::Color(currentColor.r, currentColor.g, currentColor.b, 128 / i));
             }
             break;
         }
         
         case ProjectileType::BossAttack: {
             // Draw boss attack as dark energy ball
-            sf::CircleShape energyBall(currentSize);
-            energyBall.setFillColor(currentColor);
-            energyBall.setOrigin(currentSize, currentSize);
-            energyBall.setPosition(position);
-            window.draw(energyBall);
+            queue.submitCircle(RenderLayer::Projectiles, position, currentSize, currentColor);
             
             // Add dark aura
-            sf::CircleShape aura(currentSize * 1.5f);
-            aura.setFillColor(sf::Color(currentColor.r, currentColor.g, currentColor.b, 32));
-            aura.setOrigin(currentSize * 1.5f, currentSize * 1.5f);
-            aura.setPosition(position);
-            window.draw(aura);
+            queue.submitCircle(RenderLayer::Projectiles, position, currentSize * 1.5f,
+                               sf::Color(currentColor.r, currentColor.g, currentColor.b, 32));
             break;
         }
     }
 }
 
-void Projectile::drawTrail(sf::RenderWindow& window) {
-    if (trail.size() < 2) return;
+void Projectile::drawTrail(const ProjectileSnapshot& snapshot, const TrailPointSnapshot* trailPoints, RenderQueue& queue) {
+    if (snapshot.trailPointCount < 2) return;
+    
+    const TrailPointSnapshot* trail = trailPoints + snapshot.firstTrailPoint;
     
     // Draw trail segments
-    for (size_t i = 1; i < trail.size(); ++i) {
-        sf::Color trailColor = color;
+    for (std::uint32_t i = 1; i < snapshot.trailPointCount; ++i) {
+        sf::Color trailColor = snapshot.color;
         trailColor.a = static_cast<sf::Uint8>(255 * trail[i].alpha * 0.5f);
         
-        float trailSize = size * trail[i].alpha;
-        sf::CircleShape trailPoint(trailSize * 0.5f);
-        trailPoint.setFillColor(trailColor);
-        trailPoint.setOrigin(trailSize * 0.5f, trailSize * 0.5f);
-        trailPoint.setPosition(trail[i].position);
-        
-        window.draw(trailPoint);
+        float trailSize = snapshot.size * trail[i].alpha;
+        queue.submitCircle(RenderLayer::Projectiles, trail[i].position, trailSize * 0.5f, trailColor);
     }
 }
 
-bool Projectile::isOffScreen(int windowWidth, int windowHeight) const {
-    return (position.x < -size || position.x > windowWidth + size ||
-            position.y < -size || position.y > windowHeight + size);
+bool Projectile::isOutside(const sf::FloatRect& bounds) const {
+    return (position.x < bounds.left - size || position.x > bounds.left + bounds.width + size ||
+            position.y < bounds.top - size || position.y > bounds.top + bounds.height + size);
 }
 
 sf::FloatRect Projectile::getBounds() const {
@@ -1,6 +1,12 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <vector>
+#include "TimingWheel.h"
+
+struct ProjectileSnapshot;
+struct TrailPointSnapshot;
+class RenderQueue;
 
 enum class ProjectileType {
     Laser,
@@ -10,16 +16,21 @@ enum class ProjectileType {
 
 class Projectile {
 public:
-    Projectile(sf::Vector2f startPosition, sf::Vector2f targetPosition, ProjectileType type = ProjectileType::Laser);
+    Projectile(sf::Vector2f startPosition, sf::Vector2f targetPosition, ProjectileType type, TimingWheel& timers);
     ~Projectile();
     
     void update(float deltaTime);
-    void render(sf::RenderWindow& window);
+    
+    // Rendering works from snapshots so it can run on the render thread.
+    // Trail points are appended to trailPoints and referenced by index.
+    void writeSnapshot(ProjectileSnapshot& snapshot, std::vector<TrailPointSnapshot>& trailPoints) const;
+    static void render(const ProjectileSnapshot& snapshot, const TrailPointSnapshot* trailPoints, RenderQueue& queue);
+    static sf::FloatRect getRenderBounds(const ProjectileSnapshot& snapshot, const TrailPointSnapshot* trailPoints);
     
     // State management
     bool isActive() const { return active; }
     void deactivate() { active = false; }
-    bool isOffScreen(int windowWidth, int windowHeight) const;
+    bool isOutside(const sf::FloatRect& bounds) const;
     
     // Position and collision
     sf::Vector2f getPosition() const { return position; }
@@ -29,6 +40,9 @@ public:
     ProjectileType getType() const { return type; }
     float getDamage() const { return damage; }
     
+    // Longer trails are trimmed on the next update
+    void setMaxTrailPoints(int count) { maxTrailPoints = count; }
+    
 private:
     // Core properties
     sf::Vector2f position;
@@ -44,9 +58,12 @@ private:
     
     // Visual properties
     sf::Color color;
-    float lifetime;
     float maxLifetime;
     
+    // Expiry fires from the game's timing wheel; what is left of it drives the fade
+    TimingWheel& timers;
+    TimerHandle expiryTimer;
+    
     // Animation
     float animationTimer;
     float pulseFrequency;
@@ -63,8 +80,8 @@ private:
     // Helper methods
     void initializeByType();
     void updateTrail(float deltaTime);
-    void drawLaser(sf::RenderWindow& window);
-    void drawTrail(sf::RenderWindow& window);
+    static void drawLaser(const ProjectileSnapshot& snapshot, RenderQueue& queue);
+    static void drawTrail(const ProjectileSnapshot& snapshot, const TrailPointSnapshot* trailPoints, RenderQueue& queue);
     void calculateDirection(sf::Vector2f startPos, sf::Vector2f targetPos);
     
     // Constants
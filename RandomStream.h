@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+// Counter-based generator: draw n of the stream is a hash of n, so a loop over
+// particles or ghost lanes carries no generator state from one to the next.
+// Returns [0, 1).
+inline float randomUnit(std::uint32_t seed, std::uint32_t counter) {
+    std::uint32_t x = seed ^ (counter * 0x9E3779B9u);
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,460 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+    sf::Vector2f computeNormal(const sf::Vector2f& p1, const sf::Vector2f& p2) {
+        sf::Vector2f normal(p1.y - p2.y, p2.x - p1.x);
+        float length = std::sqrt(normal.x * normal.x + normal.y * normal.y);
+        if (length != 0.0f) {
+            normal /= length;
+        }
+        return normal;
+    }
+
+    float dotProduct(const sf::Vector2f& a, const sf::Vector2f& b) {
+        return a.x * b.x + a.y * b.y;
+    }
+}
+
+RenderQueue::RenderQueue()
+    : pixelScale(1.0f)
+    , frameCount(0) {
+}
+
+void RenderQueue::submit(RenderLayer layer, const sf::Shape& shape, const sf::BlendMode& blendMode) {
+    const std::size_t pointCount = shape.getPointCount();
+    if (pointCount < 3) {
+        return;
+    }
+
+    Packet packet;
+    packet.drawable = nullptr;
+    packet.texture = shape.getTexture();
+    packet.blendMode = blendMode;
+    packet.primitive = sf::Triangles;
+    packet.firstVertex = static_cast<std::uint32_t>(vertices.size());
+
+    // Local points, their bounds (for texture coordinates) and centre (for outline normals)
+    shapePoints.resize(pointCount);
+    sf::Vector2f minimum = shape.getPoint(0);
+    sf::Vector2f maximum = minimum;
+    sf::Vector2f center;
+    for (std::size_t i = 0; i < pointCount; ++i) {
+        shapePoints[i] = shape.getPoint(i);
+        minimum.x = std::min(minimum.x, shapePoints[i].x);
+        minimum.y = std::min(minimum.y, shapePoints[i].y);
+        maximum.x = std::max(maximum.x, shapePoints[i].x);
+        maximum.y = std::max(maximum.y, shapePoints[i].y);
+        center += shapePoints[i];
+    }
+    center /= static_cast<float>(pointCount);
+
+    const sf::Transform& transform = shape.getTransform();
+
+    // Fill as a triangle fan around the first point (SFML shapes are convex)
+    const sf::Color& fillColor = shape.getFillColor();
+    if (fillColor.a > 0) {
+        const sf::IntRect& textureRect = shape.getTextureRect();
+        const sf::Vector2f size = maximum - minimum;
+        auto makeVertex = [&](const sf::Vector2f& point) {
+            sf::Vector2f texCoords;
+            if (packet.texture) {
+                float u = size.x > 0 ? (point.x - minimum.x) / size.x : 0.0f;
+                float v = size.y > 0 ? (point.y - minimum.y) / size.y : 0.0f;
+                texCoords = sf::Vector2f(textureRect.left + textureRect.width * u,
+                                         textureRect.top + textureRect.height * v);
+            }
+            return sf::Vertex(transform.transformPoint(point), fillColor, texCoords);
+        };
+
+        const sf::Vertex first = makeVertex(shapePoints[0]);
+        sf::Vertex previous = makeVertex(shapePoints[1]);
+        for (std::size_t i = 2; i < pointCount; ++i) {
+            sf::Vertex current = makeVertex(shapePoints[i]);
+            appendTriangle(first, previous, current);
+            previous = current;
+        }
+    }
+
+    // Outline as a ring of quads, extruded the same way sf::Shape does it
+    const float thickness = shape.getOutlineThickness();
+    const sf::Color& outlineColor = shape.getOutlineColor();
+    if (thickness != 0.0f && outlineColor.a > 0) {
+        // Untextured, so it can only share the packet when the fill is untextured too
+        if (packet.texture && vertices.size() > packet.firstVertex) {
+            packet.vertexCount = static_cast<std::uint32_t>(vertices.size()) - packet.firstVertex;
+            addPacket(layer, packet);
+            packet.firstVertex = static_cast<std::uint32_t>(vertices.size());
+        }
+        packet.texture = nullptr;
+
+        sf::Vertex firstInner, firstOuter, previousInner, previousOuter;
+        for (std::size_t i = 0; i < pointCount; ++i) {
+            const sf::Vector2f& p0 = shapePoints[i == 0 ? pointCount - 1 : i - 1];
+            const sf::Vector2f& p1 = shapePoints[i];
+            const sf::Vector2f& p2 = shapePoints[(i + 1) % pointCount];
+
+            sf::Vector2f n1 = computeNormal(p0, p1);
+            sf::Vector2f n2 = computeNormal(p1, p2);
+
+            // Make sure the normals point towards the outside of the shape
+            if (dotProduct(n1, center - p1) > 0) n1 = -n1;
+            if (dotProduct(n2, center - p1) > 0) n2 = -n2;
+
+            float factor = 1.0f + dotProduct(n1, n2);
+            sf::Vector2f normal = factor != 0.0f ? (n1 + n2) / factor : n1;
+
+            sf::Vertex inner(transform.transformPoint(p1), outlineColor);
+            sf::Vertex outer(transform.transformPoint(p1 + normal * thickness), outlineColor);
+            if (i == 0) {
+                firstInner = inner;
+                firstOuter = outer;
+            } else {
+                appendTriangle(previousInner, previousOuter, inner);
+                appendTriangle(inner, previousOuter, outer);
+            }
+            previousInner = inner;
+            previousOuter = outer;
+        }
+        appendTriangle(previousInner, previousOuter, firstInner);
+        appendTriangle(firstInner, previousOuter, firstOuter);
+    }
+
+    packet.vertexCount = static_cast<std::uint32_t>(vertices.size()) - packet.firstVertex;
+    if (packet.vertexCount > 0) {
+        addPacket(layer, packet);
+    }
+}
+
+void RenderQueue::submit(RenderLayer layer, const sf::Sprite& sprite, const sf::BlendMode& blendMode) {
+    const sf::Texture* texture = sprite.getTexture();
+    if (!texture) {
+        return;
+    }
+
+    const sf::IntRect& rect = sprite.getTextureRect();
+    const float width = static_cast<float>(std::abs(rect.width));
+    const float height = static_cast<float>(std::abs(rect.height));
+    const float left = static_cast<float>(rect.left);
+    const float right = left + rect.width;
+    const float top = static_cast<float>(rect.top);
+    const float bottom = top + rect.height;
+
+    const sf::Transform& transform = sprite.getTransform();
+    const sf::Color& color = sprite.getColor();
+    const sf::Vertex quad[4] = {
+        sf::Vertex(transform.transformPoint(sf::Vector2f(0, 0)), color, sf::Vector2f(left, top)),
+        sf::Vertex(transform.transformPoint(sf::Vector2f(width, 0)), color, sf::Vector2f(right, top)),
+        sf::Vertex(transform.transformPoint(sf::Vector2f(width, height)), color, sf::Vector2f(right, bottom)),
+        sf::Vertex(transform.transformPoint(sf::Vector2f(0, height)), color, sf::Vector2f(left, bottom))
+    };
+    submit(layer, quad, 4, sf::Quads, texture, blendMode);
+}
+
+void RenderQueue::submit(RenderLayer layer, const sf::Vertex* source, std::size_t vertexCount, sf::PrimitiveType type,
+                         const sf::Texture* texture, const sf::BlendMode& blendMode) {
+    Packet packet;
+    packet.drawable = nullptr;
+    packet.texture = texture;
+    packet.blendMode = blendMode;
+    packet.firstVertex = static_cast<std::uint32_t>(vertices.size());
+
+    // Strips, fans and quads are expanded to lists so packets can be concatenated
+    switch (type) {
+        case sf::Points:
+        case sf::Lines:
+        case sf::Triangles:
+            packet.primitive = type;
+            vertices.insert(vertices.end(), source, source + vertexCount);
+            break;
+        case sf::LineStrip:
+            packet.primitive = sf::Lines;
+            for (std::size_t i = 1; i < vertexCount; ++i) {
+                vertices.push_back(source[i - 1]);
+                vertices.push_back(source[i]);
+            }
+            break;
+        case sf::TriangleStrip:
+            packet.primitive = sf::Triangles;
+            for (std::size_t i = 2; i < vertexCount; ++i) {
+                appendTriangle(source[i - 2], source[i - 1], source[i]);
+            }
+            break;
+        case sf::TriangleFan:
+            packet.primitive = sf::Triangles;
+            for (std::size_t i = 2; i < vertexCount; ++i) {
+                appendTriangle(source[0], source[i - 1], source[i]);
+            }
+            break;
+        case sf::Quads:
+            packet.primitive = sf::Triangles;
+            for (std::size_t i = 0; i + 3 < vertexCount; i += 4) {
+                appendTriangle(source[i], source[i + 1], source[i + 2]);
+                appendTriangle(source[i], source[i + 2], source[i + 3]);
+            }
+            break;
+    }
+
+    packet.vertexCount = static_cast<std::uint32_t>(vertices.size()) - packet.firstVertex;
+    if (packet.vertexCount > 0) {
+        addPacket(layer, packet);
+    }
+}
+
+void RenderQueue::submitCircle(RenderLayer layer, sf::Vector2f center, float radius, const sf::Color& fillColor,
+                               float outlineThickness, const sf::Color& outlineColor, const sf::BlendMode& blendMode) {
+    const float outerRadius = radius + std::max(outlineThickness, 0.0f);
+    if (outerRadius <= 0.0f) {
+        return;
+    }
+    const std::vector<sf::Vector2f>& unit = circleGeometry.getUnitCircle(outerRadius * pixelScale);
+    const std::size_t pointCount = unit.size();
+
+    Packet packet;
+    packet.drawable = nullptr;
+    packet.texture = nullptr;
+    packet.blendMode = blendMode;
+    packet.primitive = sf::Triangles;
+    packet.firstVertex = static_cast<std::uint32_t>(vertices.size());
+
+    if (fillColor.a > 0 && radius > 0.0f) {
+        const sf::Vertex first(center + unit[0] * radius, fillColor);
+        sf::Vertex previous(center + unit[1] * radius, fillColor);
+        for (std::size_t i = 2; i < pointCount; ++i) {
+            sf::Vertex current(center + unit[i] * radius, fillColor);
+            appendTriangle(first, previous, current);
+            previous = current;
+        }
+    }
+
+    // Ring between the two radii; unit points are already their own normals
+    if (outlineThickness != 0.0f && outlineColor.a > 0) {
+        const float ringRadius = radius + outlineThickness;
+        for (std::size_t i = 0; i < pointCount; ++i) {
+            const sf::Vector2f& a = unit[i];
+            const sf::Vector2f& b = unit[(i + 1) % pointCount];
+            sf::Vertex innerA(center + a * radius, outlineColor);
+            sf::Vertex outerA(center + a * ringRadius, outlineColor);
+            sf::Vertex innerB(center + b * radius, outlineColor);
+            sf::Vertex outerB(center + b * ringRadius, outlineColor);
+            appendTriangle(innerA, outerA, innerB);
+            appendTriangle(innerB, outerA, outerB);
+        }
+    }
+
+    packet.vertexCount = static_cast<std::uint32_t>(vertices.size()) - packet.firstVertex;
+    if (packet.vertexCount > 0) {
+        addPacket(layer, packet);
+    }
+}
+
+void RenderQueue::submitEllipse(RenderLayer layer, sf::Vector2f center, sf::Vector2f radii, const sf::Color& fillColor,
+                                const sf::BlendMode& blendMode) {
+    if (fillColor.a == 0 || radii.x <= 0.0f || radii.y <= 0.0f) {
+        return;
+    }
+    const std::vector<sf::Vector2f>& unit = circleGeometry.getUnitCircle(std::max(radii.x, radii.y) * pixelScale);
+
+    Packet packet;
+    packet.drawable = nullptr;
+    packet.texture = nullptr;
+    packet.blendMode = blendMode;
+    packet.primitive = sf::Triangles;
+    packet.firstVertex = static_cast<std::uint32_t>(vertices.size());
+
+    auto makeVertex = [&](const sf::Vector2f& point) {
+        return sf::Vertex(sf::Vector2f(center.x + point.x * radii.x, center.y + point.y * radii.y), fillColor);
+    };
+    const sf::Vertex first = makeVertex(unit[0]);
+    sf::Vertex previous = makeVertex(unit[1]);
+    for (std::size_t i = 2; i < unit.size(); ++i) {
+        sf::Vertex current = makeVertex(unit[i]);
+        appendTriangle(first, previous, current);
+        previous = current;
+    }
+
+    packet.vertexCount = static_cast<std::uint32_t>(vertices.size()) - packet.firstVertex;
+    addPacket(layer, packet);
+}
+
+void RenderQueue::setView(RenderLayer fromLayer, const sf::View& view) {
+    viewChanges.push_back(std::make_pair(fromLayer, view));
+}
+
+void RenderQueue::submitDrawable(RenderLayer layer, const sf::Drawable& drawable) {
+    Packet packet;
+    packet.drawable = &drawable;
+    packet.texture = nullptr;
+    packet.blendMode = sf::BlendAlpha;
+    packet.primitive = sf::Triangles;
+    packet.firstVertex = 0;
+    packet.vertexCount = 0;
+    addPacket(layer, packet);
+}
+
+void RenderQueue::addPacket(RenderLayer layer, const Packet& packet) {
+    const std::uint32_t textureSlot = packet.drawable ? OPAQUE_TEXTURE_SLOT : getTextureSlot(packet.texture);
+    const std::uint64_t key =
+        (static_cast<std::uint64_t>(layer) << LAYER_SHIFT) |
+        (static_cast<std::uint64_t>(getBlendSlot(packet.blendMode)) << BLEND_SHIFT) |
+        (static_cast<std::uint64_t>(textureSlot) << TEXTURE_SHIFT) |
+        (static_cast<std::uint64_t>(packet.primitive) << PRIMITIVE_SHIFT) |
+        static_cast<std::uint64_t>(packets.size());
+
+    packets.push_back(packet);
+    keys.push_back(key);
+}
+
+std::uint32_t RenderQueue::getTextureSlot(const sf::Texture* texture) {
+    if (!texture) {
+        return 0;
+    }
+    auto it = std::find(textureSlots.begin(), textureSlots.end(), texture);
+    if (it != textureSlots.end()) {
+        return static_cast<std::uint32_t>(it - textureSlots.begin()) + 1;
+    }
+    // Packets remember their texture, so running out of slots only costs sort quality
+    if (textureSlots.size() + 1 >= OPAQUE_TEXTURE_SLOT) {
+        return OPAQUE_TEXTURE_SLOT - 1;
+    }
+    textureSlots.push_back(texture);
+    return static_cast<std::uint32_t>(textureSlots.size());
+}
+
+std::uint32_t RenderQueue::getBlendSlot(const sf::BlendMode& blendMode) {
+    auto it = std::find(blendSlots.begin(), blendSlots.end(), blendMode);
+    if (it != blendSlots.end()) {
+        return static_cast<std::uint32_t>(it - blendSlots.begin());
+    }
+    if (blendSlots.size() >= 0xFF) {
+        return 0xFF;
+    }
+    blendSlots.push_back(blendMode);
+    return static_cast<std::uint32_t>(blendSlots.size() - 1);
+}
+
+void RenderQueue::appendTriangle(const sf::Vertex& a, const sf::Vertex& b, const sf::Vertex& c) {
+    vertices.push_back(a);
+    vertices.push_back(b);
+    vertices.push_back(c);
+}
+
+void RenderQueue::sortKeys() {
+    // LSD radix sort on the state bytes only. Keys are submitted with increasing
+    // packet indices and every pass is stable, so submission order is preserved
+    // within equal state without sorting the low 32 bits.
+    const std::size_t count = keys.size();
+    std::array<std::array<std::uint32_t, 256>, 4> histograms = {};
+    for (std::uint64_t key : keys) {
+        for (int digit = 0; digit < 4; ++digit) {
+            ++histograms[digit][(key >> (PRIMITIVE_SHIFT + digit * 8)) & 0xFF];
+        }
+    }
+
+    sortScratch.resize(count);
+    for (int digit = 0; digit < 4; ++digit) {
+        auto& histogram = histograms[digit];
+        const int shift = PRIMITIVE_SHIFT + digit * 8;
+
+        // Every key has the same byte here; this pass would not move anything
+        if (histogram[(keys[0] >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        std::uint32_t offset = 0;
+        for (auto& bucket : histogram) {
+            std::uint32_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+        for (std::uint64_t key : keys) {
+            sortScratch[histogram[(key >> shift) & 0xFF]++] = key;
+        }
+        keys.swap(sortScratch);
+    }
+}
+
+void RenderQueue::flush(sf::RenderTarget& target) {
+    frameStats = RenderQueueStats();
+    frameStats.submitted = packets.size();
+    frameStats.vertices = vertices.size();
+
+    if (!keys.empty()) {
+        sortKeys();
+    }
+
+    // Views apply in layer order; a batch never spans a view change
+    std::stable_sort(viewChanges.begin(), viewChanges.end(),
+        [](const std::pair<RenderLayer, sf::View>& a, const std::pair<RenderLayer, sf::View>& b) {
+            return a.first < b.first;
+        });
+    std::size_t nextView = 0;
+
+    std::size_t i = 0;
+    while (i < keys.size()) {
+        while (nextView < viewChanges.size() &&
+               keys[i] >= static_cast<std::uint64_t>(viewChanges[nextView].first) << LAYER_SHIFT) {
+            target.setView(viewChanges[nextView].second);
+            ++nextView;
+        }
+        const std::uint64_t viewBoundary = nextView < viewChanges.size()
+            ? static_cast<std::uint64_t>(viewChanges[nextView].first) << LAYER_SHIFT
+            : ~0ull;
+
+        const Packet& first = packets[static_cast<std::uint32_t>(keys[i])];
+        if (first.drawable) {
+            target.draw(*first.drawable);
+            ++frameStats.drawCalls;
+            ++i;
+            continue;
+        }
+
+        // Extend the run over every following packet with the same state
+        const std::uint64_t state = keys[i] & STATE_MASK;
+        std::size_t end = i + 1;
+        while (end < keys.size() && keys[end] < viewBoundary && (keys[end] & STATE_MASK) == state) {
+            const Packet& next = packets[static_cast<std::uint32_t>(keys[end])];
+            if (next.drawable || next.texture != first.texture || next.blendMode != first.blendMode) {
+                break;
+            }
+            ++end;
+        }
+
+        sf::RenderStates states(first.blendMode);
+        states.texture = first.texture;
+        if (end - i == 1) {
+            target.draw(&vertices[first.firstVertex], first.vertexCount, first.primitive, states);
+        } else {
+            batchVertices.clear();
+            for (std::size_t j = i; j < end; ++j) {
+                const Packet& packet = packets[static_cast<std::uint32_t>(keys[j])];
+                batchVertices.insert(batchVertices.end(),
+                                     vertices.begin() + packet.firstVertex,
+                                     vertices.begin() + packet.firstVertex + packet.vertexCount);
+            }
+            target.draw(batchVertices.data(), batchVertices.size(), first.primitive, states);
+        }
+        ++frameStats.batches;
+        ++frameStats.drawCalls;
+        i = end;
+    }
+
+    totalStats.submitted += frameStats.submitted;
+    totalStats.batches += frameStats.batches;
+    totalStats.drawCalls += frameStats.drawCalls;
+    totalStats.vertices += frameStats.vertices;
+    ++frameCount;
+
+    clear();
+}
+
+void RenderQueue::clear() {
+    packets.clear();
+    keys.clear();
+    vertices.clear();
+    textureSlots.clear();
+    blendSlots.clear();
+    viewChanges.clear();
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "CircleGeometry.h"
+
+// Draw order between layers is fixed; within a layer, packets are grouped by state
+enum class RenderLayer : std::uint8_t {
+    Sky,
+    Stars,
+    FarCity,
+    Background,
+    Superman,
+    Ghosts,
+    Projectiles,
+    Particles,
+    Hud,
+    Overlay,
+    OverlayText
+};
+
+struct RenderQueueStats {
+    std::size_t submitted = 0; // Packets submitted
+    std::size_t batches = 0;   // Geometry batches after merging
+    std::size_t drawCalls = 0; // Batches plus opaque drawables
+    std::size_t vertices = 0;
+};
+
+// Deferred draw list. Systems submit packets (layer, texture, blend mode,
+// primitive type, vertex range) while building a frame; flush() radix-sorts
+// them by a 64-bit key and merges neighbouring packets that share state into a
+// single draw call. Shapes are transformed into world-space triangles on
+// submit so any two packets with the same state can be merged. Packets with
+// equal layer and state keep their submission order.
+class RenderQueue {
+public:
+    RenderQueue();
+
+    void submit(RenderLayer layer, const sf::Shape& shape, const sf::BlendMode& blendMode = sf::BlendAlpha);
+    void submit(RenderLayer layer, const sf::Sprite& sprite, const sf::BlendMode& blendMode = sf::BlendAlpha);
+    void submit(RenderLayer layer, const sf::Vertex* vertices, std::size_t vertexCount, sf::PrimitiveType type,
+                const sf::Texture* texture = nullptr, const sf::BlendMode& blendMode = sf::BlendAlpha);
+
+    // Circles tessellated from the shared unit-circle tables; centre and radius in world units.
+    // A positive outline thickness grows outwards, like sf::Shape.
+    void submitCircle(RenderLayer layer, sf::Vector2f center, float radius, const sf::Color& fillColor,
+                      float outlineThickness = 0.0f, const sf::Color& outlineColor = sf::Color::Transparent,
+                      const sf::BlendMode& blendMode = sf::BlendAlpha);
+    void submitEllipse(RenderLayer layer, sf::Vector2f center, sf::Vector2f radii, const sf::Color& fillColor,
+                       const sf::BlendMode& blendMode = sf::BlendAlpha);
+
+    // Screen pixels per world unit, used to pick circle detail
+    void setPixelScale(float scale) { pixelScale = scale; }
+
+    // Draws fromLayer and every layer above it with view, until the next view change.
+    // Layers before the first change use the target's current view. Reset by flush().
+    void setView(RenderLayer fromLayer, const sf::View& view);
+
+    // Drawn unchanged in its own draw call (text); must stay alive until flush()
+    void submitDrawable(RenderLayer layer, const sf::Drawable& drawable);
+
+    // Sorts, merges and draws everything submitted since the last flush
+    void flush(sf::RenderTarget& target);
+
+    const RenderQueueStats& getFrameStats() const { return frameStats; }
+    const RenderQueueStats& getTotalStats() const { return totalStats; }
+    std::uint64_t getFrameCount() const { return frameCount; }
+
+private:
+    struct Packet {
+        const sf::Drawable* drawable; // Opaque packets only
+        const sf::Texture* texture;
+        sf::BlendMode blendMode;
+        sf::PrimitiveType primitive;  // Always a list type (Points, Lines or Triangles)
+        std::uint32_t firstVertex;
+        std::uint32_t vertexCount;
+    };
+
+    // Key layout, high to low: layer 8 | blend 8 | texture 12 | primitive 4 | packet index 32
+    static const int LAYER_SHIFT = 56;
+    static const int BLEND_SHIFT = 48;
+    static const int TEXTURE_SHIFT = 36;
+    static const int PRIMITIVE_SHIFT = 32;
+    static const std::uint64_t STATE_MASK = 0x00FFFFFF00000000ull;
+    static const std::uint32_t OPAQUE_TEXTURE_SLOT = 0xFFF;
+
+    std::vector<Packet> packets;
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint64_t> sortScratch;
+    std::vector<sf::Vertex> vertices;
+    std::vector<sf::Vertex> batchVertices;
+    std::vector<sf::Vector2f> shapePoints;
+    CircleGeometry circleGeometry;
+    float pixelScale;
+
+    // Per-frame slot tables so keys stay small; packets keep the real state
+    std::vector<const sf::Texture*> textureSlots;
+    std::vector<sf::BlendMode> blendSlots;
+
+    std::vector<std::pair<RenderLayer, sf::View>> viewChanges;
+
+    RenderQueueStats frameStats;
+    RenderQueueStats totalStats;
+    std::uint64_t frameCount;
+
+    void addPacket(RenderLayer layer, const Packet& packet);
+    std::uint32_t getTextureSlot(const sf::Texture* texture);
+    std::uint32_t getBlendSlot(const sf::BlendMode& blendMode);
+    void appendTriangle(const sf::Vertex& a, const sf::Vertex& b, const sf::Vertex& c);
+    void sortKeys();
+    void clear();
+};
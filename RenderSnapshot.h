@@ -0,0 +1,97 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "Ghost.h"
+#include "Projectile.h"
+#include "ParticleSystem.h"
+
+enum class GameState {
+    Menu,
+    Playing,
+    Paused,
+    GameOver
+};
+
+// Everything the renderer needs to draw one simulation tick. Snapshots hold
+// plain values only (no pointers back into the simulation), so the render
+// thread can read one while the simulation writes the next.
+
+struct SupermanSnapshot {
+    sf::Vector2f position;
+    sf::Vector2f capePosition;
+    float health = 0.0f;
+    float maxHealth = 1.0f;
+    float punchRange = 0.0f;
+    bool punching = false;
+    bool laserEyes = false;
+};
+
+struct GhostSnapshot {
+    sf::Vector2f position;
+    sf::Color color;
+    float size;
+    float animationTimer;
+    float healthFraction;
+    bool boss; // Aura and health bar
+};
+
+struct TrailPointSnapshot {
+    sf::Vector2f position;
+    float alpha;
+};
+
+struct ProjectileSnapshot {
+    sf::Vector2f position;
+    sf::Vector2f direction;
+    sf::Color color;
+    float size;
+    float animationTimer;
+    float pulseFrequency;
+    float lifetimeFraction;
+    ProjectileType type;
+    std::uint32_t firstTrailPoint; // Range in RenderSnapshot::trailPoints
+    std::uint32_t trailPointCount;
+};
+
+struct BulletSnapshot {
+    sf::Vector2f position;
+    float age;
+};
+
+struct ParticleSnapshot {
+    sf::Vector2f position;
+    sf::Color color;
+    float size;
+    float rotation;
+    ParticleType type;
+};
+
+struct HudSnapshot {
+    int score = 0;
+    int level = 1;
+    float health = 0.0f;
+};
+
+struct RenderSnapshot {
+    std::uint64_t tick = 0;
+    GameState state = GameState::Menu;
+    sf::Vector2f cameraCenter;
+    HudSnapshot hud;
+    SupermanSnapshot superman;
+    std::vector<GhostSnapshot> ghosts;
+    std::vector<ProjectileSnapshot> projectiles;
+    std::vector<TrailPointSnapshot> trailPoints;
+    std::vector<BulletSnapshot> bullets;
+    std::vector<ParticleSnapshot> particles;
+
+    // Empties the arrays but keeps their capacity
+    void clear() {
+        ghosts.clear();
+        projectiles.clear();
+        trailPoints.clear();
+        bullets.clear();
+        particles.clear();
+    }
+};
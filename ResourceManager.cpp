@@ -1,12 +1,35 @@
 #include "ResourceManager.h"
-#include <iostream>
 #include <filesystem>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+// Bump when a texture generator changes so cached output is regenerated
+const int ResourceManager::TEXTURE_GENERATOR_VERSION = 2;
+const int ResourceManager::SOUND_GENERATOR_VERSION = 1;
+const std::size_t ResourceManager::DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
 
 ResourceManager::ResourceManager()
     : assetsPath("assets/")
     , texturesPath("assets/textures/")
     , soundsPath("assets/sounds/")
-    , fontsPath("assets/fonts/") {
+    , fontsPath("assets/fonts/")
+    , packPath("assets/assets.pak")
+    , proceduralCache("assets/cache/")
+    , memoryBudget(DEFAULT_MEMORY_BUDGET)
+    , overBudgetReported(false) {
+    
+    // Intern the built-in names so the constants in ResourceManager.h resolve
+    textures.intern("superman");
+    textures.intern("ghost");
+    textures.intern("effects");
+    
+    soundBuffers.intern("laser");
+    soundBuffers.intern("punch");
+    soundBuffers.intern("ghost_death");
+    
+    fonts.intern("default");
+    fonts.intern("title");
 }
 
 ResourceManager::~ResourceManager() {
@@ -22,16 +45,24 @@ bool ResourceManager::initialize() {
         std::filesystem::create_directories(soundsPath);
         std::filesystem::create_directories(fontsPath);
     } catch (const std::filesystem::filesystem_error& e) {
-        logError("Failed to create asset directories: " + std::string(e.what()));
+        logError("Failed to create asset directories: %s", e.what());
     }
     
-    // Create default assets since we might not have actual asset files
-    createDefaultTextures();
-    createDefaultSounds();
+    // A single mapped pack replaces the per-file existence checks and reads
+    if (mountAssetPack(packPath)) {
+        logInfo("Mounted asset pack: %s", packPath);
+    }
     
-    // Try to load actual assets if they exist
+    // Load actual assets first so the generated defaults only fill the gaps
     loadAllAssets();
     
+    // Create default assets since we might not have actual asset files.
+    // Sounds are synthesized on a worker while the textures are generated.
+    std::future<SynthesizedSounds> synthesizedSounds = synthesizeMissingSounds();
+    createDefaultTextures();
+    logInfo("Creating default sound buffers...");
+    storeSynthesizedSounds(synthesizedSounds.get());
+    
     logInfo("Resource Manager initialized successfully");
     return true;
 }
@@ -39,177 +70,447 @@ bool ResourceManager::initialize() {
 void ResourceManager::cleanup() {
     logInfo("Cleaning up Resource Manager...");
     unloadAllAssets();
+    assetPack.close();
+}
+
+bool ResourceManager::mountAssetPack(const std::string& filename) {
+    if (!assetPack.open(filename)) {
+        return false;
+    }
+    
+    logInfo("Asset pack %s: %u entries, %zu bytes mapped", filename, assetPack.getEntryCount(),
+            assetPack.getMappedSize());
+    return true;
+}
+
+bool ResourceManager::findPackedAsset(const std::string& name, const void*& data, std::size_t& size) const {
+    return assetPack.find(name, data, size);
 }
 
 bool ResourceManager::loadTexture(const std::string& name, const std::string& filename) {
     // Check if texture already exists
     if (hasTexture(name)) {
-        logInfo("Texture '" + name + "' already loaded");
+        logInfo("Texture '%s' already loaded", name);
+        return true;
+    }
+    
+    TextureLoader loader = [filename]() {
+        auto texture = std::make_unique<sf::Texture>();
+        if (!texture->loadFromFile(filename)) {
+            texture.reset();
+        }
+        return texture;
+    };
+    
+    if (storeTexture(name, loader)) {
+        logInfo("Loaded texture: %s from %s", name, filename);
+        return true;
+    } else {
+        logError("Failed to load texture: %s", filename);
+        return false;
+    }
+}
+
+bool ResourceManager::loadTextureFromMemory(const std::string& name, const void* data, std::size_t size) {
+    if (hasTexture(name)) {
+        logInfo("Texture '%s' already loaded", name);
         return true;
     }
     
-    auto texture = std::make_unique<sf::Texture>();
+    TextureLoader loader = [data, size]() {
+        auto texture = std::make_unique<sf::Texture>();
+        if (!texture->loadFromMemory(data, size)) {
+            texture.reset();
+        }
+        return texture;
+    };
     
-    if (texture->loadFromFile(filename)) {
-        textures[name] = std::move(texture);
-        logInfo("Loaded texture: " + name + " from " + filename);
+    if (storeTexture(name, loader)) {
+        logInfo("Loaded texture: %s from memory", name);
         return true;
     } else {
-        logError("Failed to load texture: " + filename);
+        logError("Failed to load texture from memory: %s", name);
         return false;
     }
 }
 
 sf::Texture* ResourceManager::getTexture(const std::string& name) {
-    auto it = textures.find(name);
-    if (it != textures.end()) {
-        return it->second.get();
+    if (sf::Texture* resource = textures.get(textures.find(name))) {
+        return resource;
     }
     
-    logError("Texture not found: " + name);
+    logError("Texture not found: %s", name);
     return nullptr;
 }
 
 void ResourceManager::unloadTexture(const std::string& name) {
-    auto it = textures.find(name);
-    if (it != textures.end()) {
-        textures.erase(it);
-        logInfo("Unloaded texture: " + name);
+    auto id = textures.find(name);
+    if (textures.getRefCount(id) > 0) {
+        logError("Texture '%s' is still referenced, not unloading", name);
+        return;
+    }
+    if (textures.isLoaded(id)) {
+        textures.reset(id);
+        logInfo("Unloaded texture: %s", name);
     }
 }
 
 bool ResourceManager::loadSoundBuffer(const std::string& name, const std::string& filename) {
     if (hasSoundBuffer(name)) {
-        logInfo("Sound buffer '" + name + "' already loaded");
+        logInfo("Sound buffer '%s' already loaded", name);
         return true;
     }
     
-    auto soundBuffer = std::make_unique<sf::SoundBuffer>();
+    SoundBufferLoader loader = [filename]() {
+        auto soundBuffer = std::make_unique<sf::SoundBuffer>();
+        if (!soundBuffer->loadFromFile(filename)) {
+            soundBuffer.reset();
+        }
+        return soundBuffer;
+    };
     
-    if (soundBuffer->loadFromFile(filename)) {
-        soundBuffers[name] = std::move(soundBuffer);
-        logInfo("Loaded sound buffer: " + name + " from " + filename);
+    if (storeSoundBuffer(name, loader)) {
+        logInfo("Loaded sound buffer: %s from %s", name, filename);
         return true;
     } else {
-        logError("Failed to load sound buffer: " + filename);
+        logError("Failed to load sound buffer: %s", filename);
+        return false;
+    }
+}
+
+bool ResourceManager::loadSoundBufferFromMemory(const std::string& name, const void* data, std::size_t size) {
+    if (hasSoundBuffer(name)) {
+        logInfo("Sound buffer '%s' already loaded", name);
+        return true;
+    }
+    
+    SoundBufferLoader loader = [data, size]() {
+        auto soundBuffer = std::make_unique<sf::SoundBuffer>();
+        if (!soundBuffer->loadFromMemory(data, size)) {
+            soundBuffer.reset();
+        }
+        return soundBuffer;
+    };
+    
+    if (storeSoundBuffer(name, loader)) {
+        logInfo("Loaded sound buffer: %s from memory", name);
+        return true;
+    } else {
+        logError("Failed to load sound buffer from memory: %s", name);
         return false;
     }
 }
 
 sf::SoundBuffer* ResourceManager::getSoundBuffer(const std::string& name) {
-    auto it = soundBuffers.find(name);
-    if (it != soundBuffers.end()) {
-        return it->second.get();
+    if (sf::SoundBuffer* resource = soundBuffers.get(soundBuffers.find(name))) {
+        return resource;
     }
     
-    logError("Sound buffer not found: " + name);
+    logError("Sound buffer not found: %s", name);
     return nullptr;
 }
 
 void ResourceManager::unloadSoundBuffer(const std::string& name) {
-    auto it = soundBuffers.find(name);
-    if (it != soundBuffers.end()) {
-        soundBuffers.erase(it);
-        logInfo("Unloaded sound buffer: " + name);
+    auto id = soundBuffers.find(name);
+    if (soundBuffers.getRefCount(id) > 0) {
+        logError("Sound buffer '%s' is still referenced, not unloading", name);
+        return;
+    }
+    if (soundBuffers.isLoaded(id)) {
+        soundBuffers.reset(id);
+        logInfo("Unloaded sound buffer: %s", name);
     }
 }
 
 bool ResourceManager::loadFont(const std::string& name, const std::string& filename) {
     if (hasFont(name)) {
-        logInfo("Font '" + name + "' already loaded");
+        logInfo("Font '%s' already loaded", name);
         return true;
     }
     
-    auto font = std::make_unique<sf::Font>();
+    FontLoader loader = [filename]() {
+        auto font = std::make_unique<sf::Font>();
+        if (!font->loadFromFile(filename)) {
+            font.reset();
+        }
+        return font;
+    };
     
-    if (font->loadFromFile(filename)) {
-        fonts[name] = std::move(font);
-        logInfo("Loaded font: " + name + " from " + filename);
+    std::error_code error;
+    std::uintmax_t fileSize = std::filesystem::file_size(filename, error);
+    
+    if (storeFont(name, loader, error ? 0 : static_cast<std::size_t>(fileSize))) {
+        logInfo("Loaded font: %s from %s", name, filename);
         return true;
     } else {
-        logError("Failed to load font: " + filename);
+        logError("Failed to load font: %s", filename);
+        return false;
+    }
+}
+
+bool ResourceManager::loadFontFromMemory(const std::string& name, const void* data, std::size_t size) {
+    if (hasFont(name)) {
+        logInfo("Font '%s' already loaded", name);
+        return true;
+    }
+    
+    FontLoader loader = [data, size]() {
+        auto font = std::make_unique<sf::Font>();
+        if (!font->loadFromMemory(data, size)) {
+            font.reset();
+        }
+        return font;
+    };
+    
+    if (storeFont(name, loader, size)) {
+        logInfo("Loaded font: %s from memory", name);
+        return true;
+    } else {
+        logError("Failed to load font from memory: %s", name);
         return false;
     }
 }
 
 sf::Font* ResourceManager::getFont(const std::string& name) {
-    auto it = fonts.find(name);
-    if (it != fonts.end()) {
-        return it->second.get();
+    if (sf::Font* resource = fonts.get(fonts.find(name))) {
+        return resource;
     }
     
-    logError("Font not found: " + name);
+    logError("Font not found: %s", name);
     return nullptr;
 }
 
 void ResourceManager::unloadFont(const std::string& name) {
-    auto it = fonts.find(name);
-    if (it != fonts.end()) {
-        fonts.erase(it);
-        logInfo("Unloaded font: " + name);
+    auto id = fonts.find(name);
+    if (fonts.getRefCount(id) > 0) {
+        logError("Font '%s' is still referenced, not unloading", name);
+        return;
+    }
+    if (fonts.isLoaded(id)) {
+        fonts.reset(id);
+        logInfo("Unloaded font: %s", name);
     }
 }
 
+bool ResourceManager::storeTexture(const std::string& name, const TextureLoader& loader) {
+    auto texture = loader();
+    if (!texture) {
+        return false;
+    }
+    
+    sf::Vector2u size = texture->getSize();
+    textures.set(textures.intern(name), std::move(texture), static_cast<std::size_t>(size.x) * size.y * 4, loader);
+    enforceMemoryBudget();
+    return true;
+}
+
+bool ResourceManager::storeSoundBuffer(const std::string& name, const SoundBufferLoader& loader) {
+    auto soundBuffer = loader();
+    if (!soundBuffer) {
+        return false;
+    }
+    
+    std::size_t bytes = static_cast<std::size_t>(soundBuffer->getSampleCount()) * sizeof(sf::Int16);
+    soundBuffers.set(soundBuffers.intern(name), std::move(soundBuffer), bytes, loader);
+    enforceMemoryBudget();
+    return true;
+}
+
+bool ResourceManager::storeFont(const std::string& name, const FontLoader& loader, std::size_t sourceBytes) {
+    auto font = loader();
+    if (!font) {
+        return false;
+    }
+    
+    // sf::Font keeps the whole face data alive, so its source size is a fair estimate
+    fonts.set(fonts.intern(name), std::move(font), sourceBytes, loader);
+    enforceMemoryBudget();
+    return true;
+}
+
+TextureRef ResourceManager::acquireTexture(TextureId id) {
+    TextureRef ref(&textures, id);
+    enforceMemoryBudget();
+    return ref;
+}
+
+SoundBufferRef ResourceManager::acquireSoundBuffer(SoundId id) {
+    SoundBufferRef ref(&soundBuffers, id);
+    enforceMemoryBudget();
+    return ref;
+}
+
+FontRef ResourceManager::acquireFont(FontId id) {
+    FontRef ref(&fonts, id);
+    enforceMemoryBudget();
+    return ref;
+}
+
+void ResourceManager::setMemoryBudget(std::size_t bytes) {
+    memoryBudget = bytes;
+    enforceMemoryBudget();
+}
+
+void ResourceManager::enforceMemoryBudget() {
+    std::size_t total = textures.getMemoryBytes() + soundBuffers.getMemoryBytes() + fonts.getMemoryBytes();
+    
+    while (total > memoryBudget) {
+        // Pick the least recently used evictable resource across all types
+        TextureId textureId;
+        SoundId soundId;
+        FontId fontId;
+        std::uint64_t textureUse = 0;
+        std::uint64_t soundUse = 0;
+        std::uint64_t fontUse = 0;
+        bool hasTexture = textures.findEvictionCandidate(textureId, textureUse);
+        bool hasSound = soundBuffers.findEvictionCandidate(soundId, soundUse);
+        bool hasFont = fonts.findEvictionCandidate(fontId, fontUse);
+        
+        if (!hasTexture && !hasSound && !hasFont) {
+            if (!overBudgetReported) {
+                logError("Resource memory %zu bytes exceeds budget of %zu bytes, but everything left is referenced",
+                         total, memoryBudget);
+                overBudgetReported = true;
+            }
+            return;
+        }
+        
+        std::string evictedName;
+        if (hasTexture && (!hasSound || textureUse <= soundUse) && (!hasFont || textureUse <= fontUse)) {
+            evictedName = textures.getName(textureId);
+            total -= textures.evict(textureId);
+        } else if (hasSound && (!hasFont || soundUse <= fontUse)) {
+            evictedName = soundBuffers.getName(soundId);
+            total -= soundBuffers.evict(soundId);
+        } else {
+            evictedName = fonts.getName(fontId);
+            total -= fonts.evict(fontId);
+        }
+        logInfo("Evicted %s to stay within the memory budget", evictedName);
+    }
+    
+    overBudgetReported = false;
+}
+
+ResourceMemoryStats ResourceManager::getMemoryStats() const {
+    ResourceMemoryStats stats;
+    stats.textureBytes = textures.getMemoryBytes();
+    stats.soundBytes = soundBuffers.getMemoryBytes();
+    stats.fontBytes = fonts.getMemoryBytes();
+    stats.budgetBytes = memoryBudget;
+    stats.textureCount = textures.getLoadedCount();
+    stats.soundBufferCount = soundBuffers.getLoadedCount();
+    stats.fontCount = fonts.getLoadedCount();
+    stats.referencedCount = textures.getReferencedCount() + soundBuffers.getReferencedCount() + fonts.getReferencedCount();
+    stats.evictionCount = textures.getEvictionCount() + soundBuffers.getEvictionCount() + fonts.getEvictionCount();
+    stats.reloadCount = textures.getReloadCount() + soundBuffers.getReloadCount() + fonts.getReloadCount();
+    return stats;
+}
+
+void ResourceManager::logMemoryStats() {
+    ResourceMemoryStats stats = getMemoryStats();
+    logInfo("Memory: textures %zu KiB (%zu), sounds %zu KiB (%zu), fonts %zu KiB (%zu), total %zu/%zu KiB, "
+            "%zu referenced, %zu evictions, %zu reloads",
+            stats.textureBytes / 1024, stats.textureCount, stats.soundBytes / 1024, stats.soundBufferCount,
+            stats.fontBytes / 1024, stats.fontCount, stats.getTotalBytes() / 1024, stats.budgetBytes / 1024,
+            stats.referencedCount, stats.evictionCount, stats.reloadCount);
+}
+
 bool ResourceManager::loadAllAssets() {
     logInfo("Loading all assets...");
     
     bool allLoaded = true;
     
-    // Try to load textures
+    // Try to load textures (paths are relative to the assets directory)
     std::vector<std::pair<std::string, std::string>> textureFiles = {
-        {"superman", texturesPath + "superman.png"},
-        {"ghost", texturesPath + "ghost.png"},
-        {"background", texturesPath + "background.png"},
-        {"effects", texturesPath + "effects.png"}
+        {"superman", "textures/superman.png"},
+        {"ghost", "textures/ghost.png"},
+        {"effects", "textures/effects.png"}
     };
     
     for (const auto& texture : textureFiles) {
-        if (std::filesystem::exists(texture.second)) {
-            if (!loadTexture(texture.first, texture.second)) {
-                allLoaded = false;
-            }
-        } else {
-            logInfo("Texture file not found: " + texture.second + " (using default)");
+        if (!loadPackedOrLooseTexture(texture.first, texture.second)) {
+            allLoaded = false;
         }
     }
     
     // Try to load sounds
     std::vector<std::pair<std::string, std::string>> soundFiles = {
-        {"laser", soundsPath + "laser.wav"},
-        {"punch", soundsPath + "punch.wav"},
-        {"ghost_death", soundsPath + "ghost_death.wav"},
-        {"background_music", soundsPath + "background_music.ogg"}
+        {"laser", "sounds/laser.wav"},
+        {"punch", "sounds/punch.wav"},
+        {"ghost_death", "sounds/ghost_death.wav"}
     };
+    // background_music.ogg is streamed by sf::Music, never decoded into a buffer
     
     for (const auto& sound : soundFiles) {
-        if (std::filesystem::exists(sound.second)) {
-            if (!loadSoundBuffer(sound.first, sound.second)) {
-                allLoaded = false;
-            }
-        } else {
-            logInfo("Sound file not found: " + sound.second + " (using default)");
+        if (!loadPackedOrLooseSoundBuffer(sound.first, sound.second)) {
+            allLoaded = false;
         }
     }
     
     // Try to load fonts
     std::vector<std::pair<std::string, std::string>> fontFiles = {
-        {"default", fontsPath + "arial.ttf"},
-        {"title", fontsPath + "title.ttf"}
+        {"default", "fonts/arial.ttf"},
+        {"title", "fonts/title.ttf"}
     };
     
     for (const auto& font : fontFiles) {
-        if (std::filesystem::exists(font.second)) {
-            if (!loadFont(font.first, font.second)) {
-                allLoaded = false;
-            }
-        } else {
-            logInfo("Font file not found: " + font.second + " (using system default)");
+        if (!loadPackedOrLooseFont(font.first, font.second)) {
+            allLoaded = false;
         }
     }
     
     return allLoaded;
 }
 
+bool ResourceManager::loadPackedOrLooseTexture(const std::string& name, const std::string& relativePath) {
+    const void* data = nullptr;
+    std::size_t size = 0;
+    if (assetPack.find(relativePath, data, size)) {
+        return loadTextureFromMemory(name, data, size);
+    }
+    
+    std::string filename = assetsPath + relativePath;
+    if (std::filesystem::exists(filename)) {
+        return loadTexture(name, filename);
+    }
+    
+    logInfo("Texture file not found: %s (using default)", filename);
+    return true;
+}
+
+bool ResourceManager::loadPackedOrLooseSoundBuffer(const std::string& name, const std::string& relativePath) {
+    const void* data = nullptr;
+    std::size_t size = 0;
+    if (assetPack.find(relativePath, data, size)) {
+        return loadSoundBufferFromMemory(name, data, size);
+    }
+    
+    std::string filename = assetsPath + relativePath;
+    if (std::filesystem::exists(filename)) {
+        return loadSoundBuffer(name, filename);
+    }
+    
+    logInfo("Sound file not found: %s (using default)", filename);
+    return true;
+}
+
+bool ResourceManager::loadPackedOrLooseFont(const std::string& name, const std::string& relativePath) {
+    const void* data = nullptr;
+    std::size_t size = 0;
+    if (assetPack.find(relativePath, data, size)) {
+        return loadFontFromMemory(name, data, size);
+    }
+    
+    std::string filename = assetsPath + relativePath;
+    if (std::filesystem::exists(filename)) {
+        return loadFont(name, filename);
+    }
+    
+    logInfo("Font file not found: %s (using system default)", filename);
+    return true;
+}
+
 void ResourceManager::unloadAllAssets() {
     textures.clear();
     soundBuffers.clear();
@@ -221,236 +522,262 @@ bool ResourceManager::createDefaultTextures() {
     logInfo("Creating default textures...");
     
     // Create default Superman texture
-    createSupermanTexture();
+    if (!hasTexture("superman")) {
+        createSupermanTexture();
+    }
     
     // Create default Ghost texture
-    createGhostTexture();
-    
-    // Create default background texture
-    createBackgroundTexture();
+    if (!hasTexture("ghost")) {
+        createGhostTexture();
+    }
     
     // Create default effects texture
-    createEffectsTexture();
+    if (!hasTexture("effects")) {
+        createEffectsTexture();
+    }
     
     return true;
 }
 
 bool ResourceManager::createDefaultSounds() {
     logInfo("Creating default sound buffers...");
+    return storeSynthesizedSounds(synthesizeMissingSounds().get());
+}
+
+std::future<ResourceManager::SynthesizedSounds> ResourceManager::synthesizeMissingSounds() const {
+    // Decide on this thread; the worker never touches the resource tables
+    std::vector<std::string> missing;
+    const char* defaultNames[] = { "laser", "punch", "ghost_death" };
+    for (const char* name : defaultNames) {
+        if (!hasSoundBuffer(name)) {
+            missing.push_back(name);
+        }
+    }
     
-    // Create simple sound buffers (silent for now since we can't generate audio easily)
-    // In a real implementation, you would either:
-    // 1. Include actual sound files
-    // 2. Use a sound generation library
-    // 3. Load from embedded resources
-    
-    // For now, we'll create empty sound buffers to prevent crashes
-    auto emptySoundBuffer = std::make_unique<sf::SoundBuffer>();
-    // Note: Empty sound buffers will be silent but won't cause crashes
-    
-    soundBuffers["laser"] = std::make_unique<sf::SoundBuffer>(*emptySoundBuffer);
-    soundBuffers["punch"] = std::make_unique<sf::SoundBuffer>(*emptySoundBuffer);
-    soundBuffers["ghost_death"] = std::make_unique<sf::SoundBuffer>(*emptySoundBuffer);
-    soundBuffers["background_music"] = std::make_unique<sf::SoundBuffer>(*emptySoundBuffer);
+    return std::async(std::launch::async, [this, missing]() {
+        SynthesizedSounds sounds;
+        for (const auto& name : missing) {
+            sounds.emplace_back(name, loadOrSynthesizeSamples(name));
+        }
+        return sounds;
+    });
+}
+
+bool ResourceManager::storeSynthesizedSounds(SynthesizedSounds sounds) {
+    bool allStored = true;
+    for (auto& sound : sounds) {
+        const std::string name = sound.first;
+        
+        // The first load uses the samples from the worker; reloads after eviction go through the cache
+        auto pending = std::make_shared<std::vector<sf::Int16>>(std::move(sound.second));
+        SoundBufferLoader loader = [this, name, pending]() {
+            std::vector<sf::Int16> samples = pending->empty() ? loadOrSynthesizeSamples(name) : std::move(*pending);
+            pending->clear();
+            
+            auto soundBuffer = std::make_unique<sf::SoundBuffer>();
+            if (samples.empty() ||
+                !soundBuffer->loadFromSamples(samples.data(), samples.size(), 1, SoundSynth::SAMPLE_RATE)) {
+                soundBuffer.reset();
+            }
+            return soundBuffer;
+        };
+        
+        if (!storeSoundBuffer(name, loader)) {
+            logError("Failed to create %s sound", name);
+            allStored = false;
+        }
+    }
+    return allStored;
+}
+
+std::vector<sf::Int16> ResourceManager::loadOrSynthesizeSamples(const std::string& name) const {
+    ProceduralCache::Key key("sound_" + name);
+    key.add(SOUND_GENERATOR_VERSION).add(SoundSynth::SAMPLE_RATE);
+    
+    unsigned int channelCount = 0;
+    unsigned int sampleRate = 0;
+    std::vector<sf::Int16> samples;
+    if (proceduralCache.loadSamples(key, channelCount, sampleRate, samples) &&
+        channelCount == 1 && sampleRate == SoundSynth::SAMPLE_RATE) {
+        logInfo("Loaded cached %s sound", name);
+        return samples;
+    }
+    
+    SoundSynth synth;
+    if (name == "laser") {
+        synth = SoundSynth::laser();
+    } else if (name == "punch") {
+        synth = SoundSynth::punch();
+    } else if (name == "ghost_death") {
+        synth = SoundSynth::ghostDeath();
+    } else {
+        return samples;
+    }
     
-    return true;
+    samples = synth.render();
+    if (!proceduralCache.storeSamples(key, 1, SoundSynth::SAMPLE_RATE, samples)) {
+        logInfo("Could not cache synthesized %s sound", name);
+    }
+    logInfo("Synthesized %s sound (%zu samples)", name, samples.size());
+    return samples;
 }
 
 sf::Texture* ResourceManager::createColorTexture(sf::Color color, int width, int height) {
-    auto texture = std::make_unique<sf::Texture>();
-    
-    // Create image with solid color
-    sf::Image image;
-    image.create(width, height, color);
+    TextureLoader loader = [color, width, height]() {
+        auto texture = std::make_unique<sf::Texture>();
+        
+        // Create image with solid color
+        sf::Image image;
+        image.create(width, height, color);
+        
+        if (!texture->loadFromImage(image)) {
+            texture.reset();
+        }
+        return texture;
+    };
     
-    if (texture->loadFromImage(image)) {
-        std::string name = "color_" + std::to_string(color.toInteger());
-        textures[name] = std::move(texture);
-        return textures[name].get();
+    std::string name = "color_" + std::to_string(color.toInteger());
+    if (storeTexture(name, loader)) {
+        return textures.get(textures.find(name));
     }
     
     return nullptr;
 }
 
 bool ResourceManager::hasTexture(const std::string& name) const {
-    return textures.find(name) != textures.end();
+    return textures.isLoaded(textures.find(name));
 }
 
 bool ResourceManager::hasSoundBuffer(const std::string& name) const {
-    return soundBuffers.find(name) != soundBuffers.end();
+    return soundBuffers.isLoaded(soundBuffers.find(name));
 }
 
 bool ResourceManager::hasFont(const std::string& name) const {
-    return fonts.find(name) != fonts.end();
+    return fonts.isLoaded(fonts.find(name));
 }
 
-void ResourceManager::createSupermanTexture() {
-    sf::Image supermanImage;
-    supermanImage.create(64, 64, sf::Color::Transparent);
-    
-    // Draw Superman sprite (simplified)
-    // Body (blue)
-    for (int x = 20; x < 44; ++x) {
-        for (int y = 25; y < 50; ++y) {
-            supermanImage.setPixel(x, y, sf::Color::Blue);
+bool ResourceManager::loadOrGenerateTexture(const std::string& name, const ProceduralCache::Key& key,
+                                            const std::function<void(PixelCanvas&)>& generate) {
+    // Also serves as the reload path after eviction, which then normally hits the cache
+    TextureLoader loader = [this, name, key, generate]() {
+        auto texture = std::make_unique<sf::Texture>();
+        unsigned int width = 0;
+        unsigned int height = 0;
+        std::vector<sf::Uint8> cachedPixels;
+        
+        if (proceduralCache.loadPixels(key, width, height, cachedPixels) && texture->create(width, height)) {
+            texture->update(cachedPixels.data());
+            logInfo("Loaded cached %s texture", name);
+            return texture;
         }
-    }
-    
-    // Cape (red)
-    for (int x = 10; x < 25; ++x) {
-        for (int y = 25; y < 55; ++y) {
-            supermanImage.setPixel(x, y, sf::Color::Red);
+        
+        PixelCanvas canvas;
+        generate(canvas);
+        if (!canvas.copyToTexture(*texture)) {
+            texture.reset();
+            return texture;
         }
-    }
-    
-    // Logo (red rectangle on chest)
-    for (int x = 25; x < 39; ++x) {
-        for (int y = 30; y < 40; ++y) {
-            supermanImage.setPixel(x, y, sf::Color::Red);
+        if (!proceduralCache.storePixels(key, canvas.getWidth(), canvas.getHeight(), canvas.getPixelsPtr())) {
+            logInfo("Could not cache generated %s texture", name);
         }
-    }
+        return texture;
+    };
     
-    // Head (skin color)
-    sf::Color skinColor(255, 220, 177);
-    for (int x = 25; x < 39; ++x) {
-        for (int y = 15; y < 28; ++y) {
-            int dx = x - 32;
-            int dy = y - 21;
-            if (dx*dx + dy*dy < 49) { // Circular head
-                supermanImage.setPixel(x, y, skinColor);
-            }
-        }
+    if (!storeTexture(name, loader)) {
+        logError("Failed to create %s texture", name);
+        return false;
     }
+    return true;
+}
+
+void ResourceManager::createSupermanTexture() {
+    const unsigned int size = 64;
+    ProceduralCache::Key key("superman");
+    key.add(TEXTURE_GENERATOR_VERSION).add(size);
+    
+    bool created = loadOrGenerateTexture("superman", key, [size](PixelCanvas& canvas) {
+        canvas.create(size, size, sf::Color::Transparent);
+        
+        // Draw Superman sprite (simplified)
+        canvas.fillRect(20, 25, 24, 25, sf::Color::Blue);   // Body
+        canvas.fillRect(10, 25, 15, 30, sf::Color::Red);    // Cape
+        canvas.fillRect(25, 30, 14, 10, sf::Color::Red);    // Logo on chest
+        
+        // Head (circular, skin color)
+        canvas.fillCircle(32, 21, 49, sf::Color(255, 220, 177), sf::IntRect(25, 15, 14, 13));
+    });
     
-    auto texture = std::make_unique<sf::Texture>();
-    if (texture->loadFromImage(supermanImage)) {
-        textures["superman"] = std::move(texture);
+    if (created) {
         logInfo("Created default Superman texture");
     }
 }
 
 void ResourceManager::createGhostTexture() {
-    sf::Image ghostImage;
-    ghostImage.create(64, 64, sf::Color::Transparent);
-    
-    // Ghost body (white/transparent)
-    sf::Color ghostColor(255, 255, 255, 200);
-    
-    // Main body (circle)
-    for (int x = 15; x < 49; ++x) {
-        for (int y = 15; y < 45; ++y) {
-            int dx = x - 32;
-            int dy = y - 30;
-            if (dx*dx + dy*dy < 256) { // Circular body
-                ghostImage.setPixel(x, y, ghostColor);
-            }
-        }
-    }
+    const unsigned int size = 64;
+    ProceduralCache::Key key("ghost");
+    key.add(TEXTURE_GENERATOR_VERSION).add(size);
     
-    // Wavy bottom
-    for (int x = 15; x < 49; ++x) {
-        for (int y = 45; y < 55; ++y) {
+    bool created = loadOrGenerateTexture("ghost", key, [size](PixelCanvas& canvas) {
+        canvas.create(size, size, sf::Color::Transparent);
+        
+        // Ghost body (white/transparent)
+        sf::Color ghostColor(255, 255, 255, 200);
+        
+        // Main body (circle)
+        canvas.fillCircle(32, 30, 256, ghostColor, sf::IntRect(15, 15, 34, 30));
+        
+        // Wavy bottom, one column at a time
+        for (int x = 15; x < 49; ++x) {
             int wave = static_cast<int>(3 * std::sin((x - 15) * 0.5f));
-            if (y < 50 + wave) {
-                ghostImage.setPixel(x, y, ghostColor);
-            }
+            canvas.fillRect(x, 45, 1, 5 + wave, ghostColor);
         }
-    }
-    
-    // Eyes (black)
-    for (int x = 26; x < 30; ++x) {
-        for (int y = 25; y < 29; ++y) {
-            ghostImage.setPixel(x, y, sf::Color::Black);
-        }
-    }
-    for (int x = 34; x < 38; ++x) {
-        for (int y = 25; y < 29; ++y) {
-            ghostImage.setPixel(x, y, sf::Color::Black);
-        }
-    }
+        
+        // Eyes (black)
+        canvas.fillRect(26, 25, 4, 4, sf::Color::Black);
+        canvas.fillRect(34, 25, 4, 4, sf::Color::Black);
+    });
     
-    auto texture = std::make_unique<sf::Texture>();
-    if (texture->loadFromImage(ghostImage)) {
-        textures["ghost"] = std::move(texture);
+    if (created) {
         logInfo("Created default Ghost texture");
     }
 }
 
-void ResourceManager::createBackgroundTexture() {
-    sf::Image backgroundImage;
-    backgroundImage.create(800, 600, sf::Color(10, 10, 30)); // Dark night sky
-    
-    // Add some stars
-    for (int i = 0; i < 200; ++i) {
-        int x = rand() % 800;
-        int y = rand() % 400; // Only in upper part
-        backgroundImage.setPixel(x, y, sf::Color::White);
-    }
+void ResourceManager::createEffectsTexture() {
+    const unsigned int size = 128;
+    ProceduralCache::Key key("effects");
+    key.add(TEXTURE_GENERATOR_VERSION).add(size);
     
-    // Add city silhouette at bottom
-    sf::Color buildingColor(5, 5, 15);
-    for (int x = 0; x < 800; ++x) {
-        int buildingHeight = 100 + (rand() % 150);
-        for (int y = 600 - buildingHeight; y < 600; ++y) {
-            backgroundImage.setPixel(x, y, buildingColor);
+    bool created = loadOrGenerateTexture("effects", key, [size](PixelCanvas& canvas) {
+        canvas.create(size, size, sf::Color::Transparent);
+        
+        // Explosion effect (circular gradient). Alpha is looked up by squared
+        // distance, so there is no square root per pixel.
+        const int radius = 32;
+        std::vector<std::uint32_t> gradient(radius * radius);
+        for (int distanceSquared = 0; distanceSquared < radius * radius; ++distanceSquared) {
+            float distance = std::sqrt(static_cast<float>(distanceSquared));
+            sf::Uint8 alpha = static_cast<sf::Uint8>(255 * (1.0f - distance / radius));
+            gradient[distanceSquared] = PixelCanvas::pack(sf::Color(255, 100, 0, alpha));
         }
         
-        // Add some random windows
-        if (rand() % 20 == 0) {
-            for (int wy = 600 - buildingHeight + 20; wy < 600 - 20; wy += 25) {
-                for (int wx = x; wx < x + 8 && wx < 800; ++wx) {
-                    backgroundImage.setPixel(wx, wy, sf::Color::Yellow);
+        for (int y = 0; y < 2 * radius; ++y) {
+            std::uint32_t* row = canvas.row(static_cast<unsigned int>(y));
+            int dy = y - radius;
+            for (int x = 0; x < 2 * radius; ++x) {
+                int dx = x - radius;
+                int distanceSquared = dx*dx + dy*dy;
+                if (distanceSquared < radius * radius) {
+                    row[x] = gradient[distanceSquared];
                 }
             }
         }
-    }
-    
-    auto texture = std::make_unique<sf::Texture>();
-    if (texture->loadFromImage(backgroundImage)) {
-        textures["background"] = std::move(texture);
-        logInfo("Created default Background texture");
-    }
-}
-
-void ResourceManager::createEffectsTexture() {
-    sf::Image effectsImage;
-    effectsImage.create(128, 128, sf::Color::Transparent);
-    
-    // Create various effect patterns
-    // Explosion effect (circular gradient)
-    for (int x = 0; x < 64; ++x) {
-        for (int y = 0; y < 64; ++y) {
-            int dx = x - 32;
-            int dy = y - 32;
-            float distance = std::sqrt(dx*dx + dy*dy);
-            if (distance < 32) {
-                sf::Uint8 alpha = static_cast<sf::Uint8>(255 * (1.0f - distance / 32.0f));
-                effectsImage.setPixel(x, y, sf::Color(255, 100, 0, alpha));
-            }
-        }
-    }
-    
-    // Laser effect (horizontal beam)
-    for (int x = 64; x < 128; ++x) {
-        for (int y = 30; y < 34; ++y) {
-            effectsImage.setPixel(x, y, sf::Color::Red);
-        }
-        for (int y = 28; y < 36; ++y) {
-            effectsImage.setPixel(x, y, sf::Color(255, 0, 0, 128));
-        }
-    }
+        
+        // Laser effect (horizontal beam with a translucent glow)
+        canvas.fillRect(64, 30, 64, 4, sf::Color::Red);
+        canvas.fillRect(64, 28, 64, 8, sf::Color(255, 0, 0, 128));
+    });
     
-    auto texture = std::make_unique<sf::Texture>();
-    if (texture->loadFromImage(effectsImage)) {
-        textures["effects"] = std::move(texture);
+    if (created) {
         logInfo("Created default Effects texture");
     }
 }
-
-void ResourceManager::logError(const std::string& message) {
-    std::cerr << "[ResourceManager ERROR] " << message << std::endl;
-}
-
-void ResourceManager::logInfo(const std::string& message) {
-    std::cout << "[ResourceManager INFO] " << message << std::endl;
-}
\ No newline at end of file
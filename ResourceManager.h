@@ -2,9 +2,64 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
-#include <unordered_map>
 #include <string>
 #include <memory>
+#include <functional>
+#include <future>
+#include <utility>
+#include <vector>
+#include "AssetPack.h"
+#include "Logger.h"
+#include "ProceduralCache.h"
+#include "PixelCanvas.h"
+#include "ResourceTable.h"
+#include "SoundSynth.h"
+
+struct TextureTag;
+struct SoundTag;
+struct FontTag;
+typedef ResourceId<TextureTag> TextureId;
+typedef ResourceId<SoundTag> SoundId;
+typedef ResourceId<FontTag> FontId;
+
+typedef ResourceRef<sf::Texture, TextureTag> TextureRef;
+typedef ResourceRef<sf::SoundBuffer, SoundTag> SoundBufferRef;
+typedef ResourceRef<sf::Font, FontTag> FontRef;
+
+// Where resource memory goes. Texture bytes are the uploaded RGBA size, sound
+// bytes the decoded 16-bit PCM and font bytes the size of the face data.
+struct ResourceMemoryStats {
+    std::size_t textureBytes = 0;
+    std::size_t soundBytes = 0;
+    std::size_t fontBytes = 0;
+    std::size_t budgetBytes = 0;
+    std::size_t textureCount = 0;
+    std::size_t soundBufferCount = 0;
+    std::size_t fontCount = 0;
+    std::size_t referencedCount = 0;
+    std::size_t evictionCount = 0;
+    std::size_t reloadCount = 0;
+    
+    std::size_t getTotalBytes() const { return textureBytes + soundBytes + fontBytes; }
+};
+
+// Built-in assets, interned by ResourceManager's constructor in this order
+namespace TextureIds {
+    const TextureId Superman(0);
+    const TextureId Ghost(1);
+    const TextureId Effects(2);
+}
+
+namespace SoundIds {
+    const SoundId Laser(0);
+    const SoundId Punch(1);
+    const SoundId GhostDeath(2);
+}
+
+namespace FontIds {
+    const FontId Default(0);
+    const FontId Title(1);
+}
 
 class ResourceManager {
 public:
@@ -17,19 +72,47 @@ public:
     
     // Texture management
     bool loadTexture(const std::string& name, const std::string& filename);
+    bool loadTextureFromMemory(const std::string& name, const void* data, std::size_t size);
     sf::Texture* getTexture(const std::string& name);
+    sf::Texture* getTexture(TextureId id) const { return textures.get(id); }
+    TextureId getTextureId(const std::string& name) { return textures.intern(name); }
     void unloadTexture(const std::string& name);
     
     // Sound management
     bool loadSoundBuffer(const std::string& name, const std::string& filename);
+    bool loadSoundBufferFromMemory(const std::string& name, const void* data, std::size_t size);
     sf::SoundBuffer* getSoundBuffer(const std::string& name);
+    sf::SoundBuffer* getSoundBuffer(SoundId id) const { return soundBuffers.get(id); }
+    SoundId getSoundId(const std::string& name) { return soundBuffers.intern(name); }
     void unloadSoundBuffer(const std::string& name);
     
     // Font management
     bool loadFont(const std::string& name, const std::string& filename);
+    // The data must outlive the font (sf::Font streams glyphs from it)
+    bool loadFontFromMemory(const std::string& name, const void* data, std::size_t size);
     sf::Font* getFont(const std::string& name);
+    sf::Font* getFont(FontId id) const { return fonts.get(id); }
+    FontId getFontId(const std::string& name) { return fonts.intern(name); }
     void unloadFont(const std::string& name);
     
+    // Reference-counted access. Referenced resources are never evicted; raw
+    // pointers from get*() are only guaranteed until the next load or acquire.
+    TextureRef acquireTexture(TextureId id);
+    SoundBufferRef acquireSoundBuffer(SoundId id);
+    FontRef acquireFont(FontId id);
+    
+    // Memory budget. Unreferenced, reloadable resources are evicted least
+    // recently used first whenever the total exceeds it.
+    void setMemoryBudget(std::size_t bytes);
+    std::size_t getMemoryBudget() const { return memoryBudget; }
+    ResourceMemoryStats getMemoryStats() const;
+    void logMemoryStats();
+    
+    // Asset pack (memory-mapped, see AssetPack.h)
+    bool mountAssetPack(const std::string& filename);
+    bool isAssetPackMounted() const { return assetPack.isOpen(); }
+    bool findPackedAsset(const std::string& name, const void*& data, std::size_t& size) const;
+    
     // Batch loading
     bool loadAllAssets();
     void unloadAllAssets();
@@ -45,15 +128,18 @@ public:
     bool hasFont(const std::string& name) const;
     
     // Statistics
-    size_t getTextureCount() const { return textures.size(); }
-    size_t getSoundBufferCount() const { return soundBuffers.size(); }
-    size_t getFontCount() const { return fonts.size(); }
+    size_t getTextureCount() const { return textures.getLoadedCount(); }
+    size_t getSoundBufferCount() const { return soundBuffers.getLoadedCount(); }
+    size_t getFontCount() const { return fonts.getLoadedCount(); }
     
 private:
-    // Resource containers
-    std::unordered_map<std::string, std::unique_ptr<sf::Texture>> textures;
-    std::unordered_map<std::string, std::unique_ptr<sf::SoundBuffer>> soundBuffers;
-    std::unordered_map<std::string, std::unique_ptr<sf::Font>> fonts;
+    // Mapped pack; declared before the containers so fonts loaded from it are destroyed first
+    AssetPack assetPack;
+    
+    // Resource containers (names are resolved to dense slots once, at load time)
+    ResourceTable<sf::Texture, TextureTag> textures;
+    ResourceTable<sf::SoundBuffer, SoundTag> soundBuffers;
+    ResourceTable<sf::Font, FontTag> fonts;
     
     // Helper methods
     bool directoryExists(const std::string& path);
@@ -65,14 +151,50 @@ private:
     std::string texturesPath;
     std::string soundsPath;
     std::string fontsPath;
+    std::string packPath;
+    
+    // Generated textures and sounds are cached on disk next to the assets
+    ProceduralCache proceduralCache;
+    
+    // Memory accounting
+    std::size_t memoryBudget;
+    bool overBudgetReported;
+    void enforceMemoryBudget();
+    
+    // Creates the resource with loader and keeps loader for reloads after eviction
+    typedef ResourceTable<sf::Texture, TextureTag>::Loader TextureLoader;
+    typedef ResourceTable<sf::SoundBuffer, SoundTag>::Loader SoundBufferLoader;
+    typedef ResourceTable<sf::Font, FontTag>::Loader FontLoader;
+    bool storeTexture(const std::string& name, const TextureLoader& loader);
+    bool storeSoundBuffer(const std::string& name, const SoundBufferLoader& loader);
+    bool storeFont(const std::string& name, const FontLoader& loader, std::size_t sourceBytes);
+    
+    // Loads from the mounted pack if it has the entry, otherwise from the loose file
+    bool loadPackedOrLooseTexture(const std::string& name, const std::string& relativePath);
+    bool loadPackedOrLooseSoundBuffer(const std::string& name, const std::string& relativePath);
+    bool loadPackedOrLooseFont(const std::string& name, const std::string& relativePath);
     
     // Default asset creation
+    bool loadOrGenerateTexture(const std::string& name, const ProceduralCache::Key& key,
+                               const std::function<void(PixelCanvas&)>& generate);
     void createSupermanTexture();
     void createGhostTexture();
-    void createBackgroundTexture();
     void createEffectsTexture();
     
-    // Error handling
-    void logError(const std::string& message);
-    void logInfo(const std::string& message);
+    // Default sounds are synthesized (or read from the cache) on a worker thread
+    // and turned into buffers on the calling thread
+    typedef std::vector<std::pair<std::string, std::vector<sf::Int16>>> SynthesizedSounds;
+    std::future<SynthesizedSounds> synthesizeMissingSounds() const;
+    bool storeSynthesizedSounds(SynthesizedSounds sounds);
+    std::vector<sf::Int16> loadOrSynthesizeSamples(const std::string& name) const;
+    
+    static const int TEXTURE_GENERATOR_VERSION;
+    static const int SOUND_GENERATOR_VERSION;
+    static const std::size_t DEFAULT_MEMORY_BUDGET;
+    
+    // Error handling; formats are printf-style literals, written by the Logger thread
+    template <typename... Args>
+    void logError(const char* format, const Args&... args) const { LOG_ERROR("ResourceManager", format, args...); }
+    template <typename... Args>
+    void logInfo(const char* format, const Args&... args) const { LOG_INFO("ResourceManager", format, args...); }
 };
\ No newline at end of file
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Monotonic use counter shared by every ResourceTable, so LRU order is
+// comparable across resource types
+inline std::uint64_t nextResourceUseTick() {
+    static std::uint64_t clock = 0;
+    return ++clock;
+}
+
+// Typed index into a ResourceTable. Resolving a name to an ID happens once at
+// load time; every lookup after that is a bounds check and a vector index.
+template <typename Tag>
+class ResourceId {
+public:
+    static const std::uint32_t INVALID = 0xFFFFFFFFu;
+
+    ResourceId() : index(INVALID) {}
+    explicit ResourceId(std::uint32_t slotIndex) : index(slotIndex) {}
+
+    bool isValid() const { return index != INVALID; }
+    std::uint32_t getIndex() const { return index; }
+
+    bool operator==(const ResourceId& other) const { return index == other.index; }
+    bool operator!=(const ResourceId& other) const { return index != other.index; }
+
+private:
+    std::uint32_t index;
+};
+
+// Dense storage for one resource type. Names are interned into stable slots;
+// unloading a resource empties its slot but keeps the ID valid, so handles
+// resolved earlier stay usable once it is loaded again.
+//
+// Each slot also tracks its memory footprint, a reference count and when it
+// was last used. Unreferenced slots that know how to reload themselves can be
+// evicted by the owner to stay within a memory budget.
+template <typename T, typename Tag>
+class ResourceTable {
+public:
+    typedef ResourceId<Tag> Id;
+    typedef std::function<std::unique_ptr<T>()> Loader;
+
+    // Returns the ID for name, creating an empty slot the first time
+    Id intern(const std::string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return Id(it->second);
+        }
+
+        std::uint32_t index = static_cast<std::uint32_t>(slots.size());
+        ids.emplace(name, index);
+        names.push_back(name);
+        slots.emplace_back();
+        return Id(index);
+    }
+
+    // Returns an invalid ID if the name was never interned
+    Id find(const std::string& name) const {
+        auto it = ids.find(name);
+        return it != ids.end() ? Id(it->second) : Id();
+    }
+
+    T* get(Id id) const {
+        if (id.getIndex() >= slots.size()) {
+            return nullptr;
+        }
+        const Slot& slot = slots[id.getIndex()];
+        slot.lastUse = nextResourceUseTick();
+        return slot.resource.get();
+    }
+
+    bool isLoaded(Id id) const {
+        return id.getIndex() < slots.size() && slots[id.getIndex()].resource != nullptr;
+    }
+
+    // bytes is the resource's memory footprint; loader (optional) recreates it after eviction
+    void set(Id id, std::unique_ptr<T> resource, std::size_t bytes, Loader loader = Loader()) {
+        if (id.getIndex() >= slots.size()) {
+            return;
+        }
+        Slot& slot = slots[id.getIndex()];
+        slot.resource = std::move(resource);
+        slot.bytes = slot.resource ? bytes : 0;
+        slot.loadedBytes = slot.bytes;
+        slot.loader = std::move(loader);
+        slot.evicted = false;
+        slot.lastUse = nextResourceUseTick();
+    }
+
+    void reset(Id id) {
+        if (id.getIndex() < slots.size()) {
+            Slot& slot = slots[id.getIndex()];
+            slot.resource.reset();
+            slot.bytes = 0;
+            slot.loader = Loader();
+            slot.evicted = false;
+        }
+    }
+
+    // Unloads every resource; IDs stay valid
+    void clear() {
+        for (auto& slot : slots) {
+            slot.resource.reset();
+            slot.bytes = 0;
+            slot.loader = Loader();
+            slot.evicted = false;
+        }
+    }
+
+    // Reference counting. acquire() reloads an evicted resource.
+    T* acquire(Id id) {
+        if (id.getIndex() >= slots.size()) {
+            return nullptr;
+        }
+        Slot& slot = slots[id.getIndex()];
+        if (!slot.resource && slot.evicted && slot.loader) {
+            // A reload produces the same resource, so it costs what it did before
+            slot.resource = slot.loader();
+            slot.bytes = slot.resource ? slot.loadedBytes : 0;
+            slot.evicted = slot.resource == nullptr;
+            ++reloadCount;
+        }
+        ++slot.refCount;
+        slot.lastUse = nextResourceUseTick();
+        return slot.resource.get();
+    }
+
+    void release(Id id) {
+        if (id.getIndex() < slots.size() && slots[id.getIndex()].refCount > 0) {
+            --slots[id.getIndex()].refCount;
+        }
+    }
+
+    std::uint32_t getRefCount(Id id) const {
+        return id.getIndex() < slots.size() ? slots[id.getIndex()].refCount : 0;
+    }
+
+    // Least recently used slot that is loaded, unreferenced, reloadable and
+    // actually frees memory
+    bool findEvictionCandidate(Id& id, std::uint64_t& lastUse) const {
+        bool found = false;
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            const Slot& slot = slots[i];
+            if (slot.resource && slot.refCount == 0 && slot.loader && slot.bytes > 0 &&
+                (!found || slot.lastUse < lastUse)) {
+                id = Id(static_cast<std::uint32_t>(i));
+                lastUse = slot.lastUse;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    // Frees the resource but keeps the loader so acquire() can bring it back
+    std::size_t evict(Id id) {
+        if (id.getIndex() >= slots.size()) {
+            return 0;
+        }
+        Slot& slot = slots[id.getIndex()];
+        std::size_t freed = slot.bytes;
+        slot.resource.reset();
+        slot.bytes = 0;
+        slot.evicted = true;
+        ++evictionCount;
+        return freed;
+    }
+
+    const std::string& getName(Id id) const { return names[id.getIndex()]; }
+    std::size_t getSlotCount() const { return slots.size(); }
+    std::size_t getLoadedCount() const {
+        return static_cast<std::size_t>(std::count_if(slots.begin(), slots.end(),
+            [](const Slot& slot) { return slot.resource != nullptr; }));
+    }
+    std::size_t getReferencedCount() const {
+        return static_cast<std::size_t>(std::count_if(slots.begin(), slots.end(),
+            [](const Slot& slot) { return slot.resource != nullptr && slot.refCount > 0; }));
+    }
+    std::size_t getMemoryBytes() const {
+        std::size_t total = 0;
+        for (const auto& slot : slots) {
+            total += slot.bytes;
+        }
+        return total;
+    }
+    std::size_t getEvictionCount() const { return evictionCount; }
+    std::size_t getReloadCount() const { return reloadCount; }
+
+private:
+    struct Slot {
+        std::unique_ptr<T> resource;
+        Loader loader;
+        std::size_t bytes = 0;
+        std::size_t loadedBytes = 0;
+        std::uint32_t refCount = 0;
+        bool evicted = false;
+        mutable std::uint64_t lastUse = 0;
+    };
+
+    std::unordered_map<std::string, std::uint32_t> ids;
+    std::vector<std::string> names;
+    std::vector<Slot> slots;
+    std::size_t evictionCount = 0;
+    std::size_t reloadCount = 0;
+};
+
+// Counted reference to a table slot. The resource is never evicted while a
+// reference to it exists. References must not outlive their table.
+template <typename T, typename Tag>
+class ResourceRef {
+public:
+    ResourceRef() : table(nullptr) {}
+
+    ResourceRef(ResourceTable<T, Tag>* owner, ResourceId<Tag> resourceId)
+        : table(owner)
+        , id(resourceId) {
+        if (table) {
+            table->acquire(id);
+        }
+    }
+
+    ResourceRef(const ResourceRef& other)
+        : table(other.table)
+        , id(other.id) {
+        if (table) {
+            table->acquire(id);
+        }
+    }
+
+    ResourceRef(ResourceRef&& other) noexcept
+        : table(other.table)
+        , id(other.id) {
+        other.table = nullptr;
+    }
+
+    ResourceRef& operator=(ResourceRef other) noexcept {
+        std::swap(table, other.table);
+        std::swap(id, other.id);
+        return *this;
+    }
+
+    ~ResourceRef() {
+        reset();
+    }
+
+    void reset() {
+        if (table) {
+            table->release(id);
+            table = nullptr;
+        }
+    }
+
+    T* get() const { return table ? table->get(id) : nullptr; }
+    T& operator*() const { return *get(); }
+    T* operator->() const { return get(); }
+    explicit operator bool() const { return get() != nullptr; }
+
+    ResourceId<Tag> getId() const { return id; }
+
+private:
+    ResourceTable<T, Tag>* table;
+    ResourceId<Tag> id;
+};
@@ -0,0 +1,190 @@
+#include "SoundSynth.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const float TWO_PI = 6.28318530718f;
+    const float PEAK_LEVEL = 0.9f;
+}
+
+float Envelope::getLevel(float time) const {
+    if (time < 0.0f) {
+        return 0.0f;
+    }
+    if (time < attack) {
+        return time / attack;
+    }
+    time -= attack;
+    if (time < decay) {
+        return 1.0f - (1.0f - sustain) * (time / decay);
+    }
+    time -= decay;
+    if (time < hold) {
+        return sustain;
+    }
+    time -= hold;
+    if (time < release) {
+        return sustain * (1.0f - time / release);
+    }
+    return 0.0f;
+}
+
+SoundSynth::SoundSynth(std::uint32_t noiseSeed)
+    : seed(noiseSeed ? noiseSeed : 1) {
+}
+
+SoundSynth& SoundSynth::addVoice(const SynthVoice& voice) {
+    voices.push_back(voice);
+    return *this;
+}
+
+float SoundSynth::getDuration() const {
+    float duration = 0.0f;
+    for (const auto& voice : voices) {
+        duration = std::max(duration, voice.startTime + voice.envelope.getLength());
+    }
+    return duration;
+}
+
+std::vector<sf::Int16> SoundSynth::render() const {
+    std::vector<float> mix(static_cast<std::size_t>(std::ceil(getDuration() * SAMPLE_RATE)), 0.0f);
+    for (std::size_t i = 0; i < voices.size(); ++i) {
+        renderVoice(voices[i], static_cast<std::uint32_t>(i), mix);
+    }
+
+    float peak = 0.0f;
+    for (float sample : mix) {
+        peak = std::max(peak, std::abs(sample));
+    }
+    const float gain = peak > 0.0f ? PEAK_LEVEL / peak : 0.0f;
+
+    std::vector<sf::Int16> samples(mix.size());
+    for (std::size_t i = 0; i < mix.size(); ++i) {
+        samples[i] = static_cast<sf::Int16>(std::lround(mix[i] * gain * 32767.0f));
+    }
+    return samples;
+}
+
+void SoundSynth::renderVoice(const SynthVoice& voice, std::uint32_t index, std::vector<float>& mix) const {
+    const float length = voice.envelope.getLength();
+    if (length <= 0.0f || voice.startFrequency <= 0.0f || voice.endFrequency <= 0.0f) {
+        return;
+    }
+
+    const std::size_t first = static_cast<std::size_t>(voice.startTime * SAMPLE_RATE);
+    const std::size_t count = static_cast<std::size_t>(length * SAMPLE_RATE);
+    const float sweep = std::log(voice.endFrequency / voice.startFrequency);
+    const float filterCoefficient = voice.lowPassCutoff > 0.0f
+        ? 1.0f - std::exp(-TWO_PI * voice.lowPassCutoff / SAMPLE_RATE)
+        : 1.0f;
+
+    // Each voice gets its own noise sequence
+    std::uint32_t noiseState = seed ^ ((index + 1) * 2654435761u);
+    if (noiseState == 0) {
+        noiseState = 1;
+    }
+
+    float phase = 0.0f;
+    float filtered = 0.0f;
+    for (std::size_t i = 0; i < count && first + i < mix.size(); ++i) {
+        const float time = static_cast<float>(i) / SAMPLE_RATE;
+        float frequency = voice.startFrequency * std::exp(sweep * time / length);
+        if (voice.vibratoDepth > 0.0f) {
+            frequency *= 1.0f + voice.vibratoDepth * std::sin(TWO_PI * voice.vibratoRate * time);
+        }
+
+        float value;
+        switch (voice.waveform) {
+            case Waveform::Square:
+                value = phase < 0.5f ? 1.0f : -1.0f;
+                break;
+            case Waveform::Saw:
+                value = 2.0f * phase - 1.0f;
+                break;
+            case Waveform::Triangle:
+                value = 1.0f - 4.0f * std::abs(phase - 0.5f);
+                break;
+            case Waveform::Noise:
+                // xorshift32
+                noiseState ^= noiseState << 13;
+                noiseState ^= noiseState >> 17;
+                noiseState ^= noiseState << 5;
+                value = static_cast<float>(noiseState) / 2147483648.0f - 1.0f;
+                break;
+            default:
+                value = std::sin(TWO_PI * phase);
+                break;
+        }
+
+        phase += frequency / SAMPLE_RATE;
+        phase -= std::floor(phase);
+
+        filtered += filterCoefficient * (value - filtered);
+        mix[first + i] += filtered * voice.amplitude * voice.envelope.getLevel(time);
+    }
+}
+
+SoundSynth SoundSynth::laser() {
+    SynthVoice zap;
+    zap.waveform = Waveform::Square;
+    zap.startFrequency = 1800.0f;
+    zap.endFrequency = 280.0f;
+    zap.amplitude = 0.6f;
+    zap.lowPassCutoff = 6000.0f;
+    zap.envelope.attack = 0.002f;
+    zap.envelope.decay = 0.05f;
+    zap.envelope.sustain = 0.5f;
+    zap.envelope.hold = 0.08f;
+    zap.envelope.release = 0.12f;
+
+    SynthVoice shimmer = zap;
+    shimmer.waveform = Waveform::Sine;
+    shimmer.startFrequency = 3600.0f;
+    shimmer.endFrequency = 560.0f;
+    shimmer.amplitude = 0.3f;
+    shimmer.lowPassCutoff = 0.0f;
+
+    return SoundSynth(0x1A5E4u).addVoice(zap).addVoice(shimmer);
+}
+
+SoundSynth SoundSynth::punch() {
+    SynthVoice thump;
+    thump.waveform = Waveform::Sine;
+    thump.startFrequency = 160.0f;
+    thump.endFrequency = 45.0f;
+    thump.envelope.attack = 0.001f;
+    thump.envelope.decay = 0.18f;
+
+    SynthVoice impact;
+    impact.waveform = Waveform::Noise;
+    impact.amplitude = 0.7f;
+    impact.lowPassCutoff = 900.0f;
+    impact.envelope.attack = 0.001f;
+    impact.envelope.decay = 0.07f;
+
+    return SoundSynth(0x9C4u).addVoice(thump).addVoice(impact);
+}
+
+SoundSynth SoundSynth::ghostDeath() {
+    SynthVoice wail;
+    wail.waveform = Waveform::Triangle;
+    wail.startFrequency = 620.0f;
+    wail.endFrequency = 90.0f;
+    wail.amplitude = 0.8f;
+    wail.vibratoRate = 7.0f;
+    wail.vibratoDepth = 0.06f;
+    wail.envelope.attack = 0.03f;
+    wail.envelope.decay = 0.2f;
+    wail.envelope.sustain = 0.6f;
+    wail.envelope.hold = 0.35f;
+    wail.envelope.release = 0.3f;
+
+    SynthVoice hiss;
+    hiss.waveform = Waveform::Noise;
+    hiss.amplitude = 0.25f;
+    hiss.lowPassCutoff = 2500.0f;
+    hiss.envelope.attack = 0.01f;
+    hiss.envelope.decay = 0.5f;
+
+    return SoundSynth(0x6057u).addVoice(wail).addVoice(hiss);
+}
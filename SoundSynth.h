@@ -0,0 +1,64 @@
+#pragma once
+
+#include <SFML/Config.hpp>
+#include <cstdint>
+#include <vector>
+
+enum class Waveform {
+    Sine,
+    Square,
+    Saw,
+    Triangle,
+    Noise
+};
+
+// Attack, decay and release in seconds; the level holds at sustain for hold seconds
+struct Envelope {
+    float attack = 0.005f;
+    float decay = 0.1f;
+    float sustain = 0.0f;
+    float hold = 0.0f;
+    float release = 0.0f;
+
+    float getLength() const { return attack + decay + hold + release; }
+    float getLevel(float time) const;
+};
+
+// One oscillator with a pitch sweep, optional vibrato and a one-pole low-pass
+struct SynthVoice {
+    Waveform waveform = Waveform::Sine;
+    float startFrequency = 440.0f;
+    float endFrequency = 440.0f;  // Swept exponentially over the envelope
+    float amplitude = 1.0f;
+    float startTime = 0.0f;
+    float vibratoRate = 0.0f;     // Hz
+    float vibratoDepth = 0.0f;    // Fraction of the frequency
+    float lowPassCutoff = 0.0f;   // Hz, 0 disables the filter
+    Envelope envelope;
+};
+
+// Small offline synthesizer for the default sound effects. Rendering is
+// deterministic for a given patch and seed, so the output can be cached.
+class SoundSynth {
+public:
+    static const unsigned int SAMPLE_RATE = 44100;
+
+    explicit SoundSynth(std::uint32_t seed = 1);
+
+    SoundSynth& addVoice(const SynthVoice& voice);
+
+    // Mono 16-bit samples covering every voice, peak-normalized
+    std::vector<sf::Int16> render() const;
+    float getDuration() const;
+
+    // Default effect patches
+    static SoundSynth laser();
+    static SoundSynth punch();
+    static SoundSynth ghostDeath();
+
+private:
+    std::vector<SynthVoice> voices;
+    std::uint32_t seed;
+
+    void renderVoice(const SynthVoice& voice, std::uint32_t index, std::vector<float>& mix) const;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded single-producer single-consumer queue. push() is only called from
+// one thread and pop() from one other thread; neither ever blocks or locks.
+// T should be a small trivially copyable type.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue()
+        : head(0)
+        , tail(0) {
+    }
+
+    // Producer side; fails when the queue is full
+    bool push(const T& item) {
+        const std::size_t write = tail.load(std::memory_order_relaxed);
+        if (write - head.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        items[write & (Capacity - 1)] = item;
+        tail.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; fails when the queue is empty
+    bool pop(T& item) {
+        const std::size_t read = head.load(std::memory_order_relaxed);
+        if (read == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[read & (Capacity - 1)];
+        head.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> items;
+    // Separate cache lines so the two threads don't contend on one
+    alignas(64) std::atomic<std::size_t> head;
+    alignas(64) std::atomic<std::size_t> tail;
+};
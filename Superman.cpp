@@ -1,4 +1,6 @@
 #include "Superman.h"
+#include "RenderSnapshot.h"
+#include "RenderQueue.h"
 #include <cmath>
 #include <algorithm>
 
@@ -6,7 +8,7 @@ const float Superman::MAX_SPEED = 300.0f;
 const float Superman::PUNCH_DAMAGE = 30.0f;
 const float Superman::SIZE = 40.0f;
 
-Superman::Superman(float x, float y)
+Superman::Superman(float x, float y, TimingWheel& timers)
     : position(x, y)
     , velocity(0, 0)
     , health(100.0f)
@@ -14,14 +16,14 @@ Superman::Superman(float x, float y)
     , speed(250.0f)
     , acceleration(800.0f)
     , friction(0.85f)
-    , punchTimer(0.0f)
+    , timers(timers)
+    , punching(false)
     , punchDuration(0.3f)
     , punchRange(80.0f)
     , animationTimer(0.0f)
     , currentFrame(0)
     , maxFrames(4)
     , capeAnimationTimer(0.0f)
-    , regenTimer(0.0f)
     , regenRate(1.0f)  // 1 second between regeneration
     , regenAmount(1.0f) // 1 health per regeneration
     , texture(nullptr) {
@@ -33,88 +35,101 @@ Superman::Superman(float x, float y)
     cape.setSize(sf::Vector2f(15, 25));
     cape.setFillColor(sf::Color::Red);
     cape.setOrigin(7.5f, 0);
+    
+    scheduleRegeneration();
 }
 
-Superman::~Superman() = default;
+Superman::~Superman() {
+    timers.cancel(punchEndTimer);
+    timers.cancel(regenTimer);
+}
 
-void Superman::update(float deltaTime, const sf::RenderWindow& window) {
+void Superman::update(float deltaTime, const sf::FloatRect& worldBounds) {
     handleInput(deltaTime);
     
     // Apply velocity
     position += velocity * deltaTime;
     
-    // Update timers
-    if (punchTimer > 0) {
-        punchTimer -= deltaTime;
-    }
-    
-    regenTimer += deltaTime;
-    
     // Update animations
     updateAnimation(deltaTime);
     updateCape(deltaTime);
     
-    // Keep Superman in window bounds
-    constrainToWindow(window);
+    // Keep Superman inside the world
+    constrainToBounds(worldBounds);
     
     // Update sprite position
     sprite.setPosition(position);
 }
 
-void Superman::render(sf::RenderWindow& window) {
+void Superman::writeSnapshot(SupermanSnapshot& snapshot) const {
+    snapshot.position = position;
+    snapshot.capePosition = cape.getPosition();
+    snapshot.health = health;
+    snapshot.maxHealth = maxHealth;
+    snapshot.punchRange = punchRange;
+    snapshot.punching = isPunching();
+    snapshot.laserEyes = sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
+}
+
+sf::FloatRect Superman::getRenderBounds(const SupermanSnapshot& snapshot) {
+    // Body, head and health bar fit in SIZE * 0.8 around the position; the cape hangs off separately
+    float extent = SIZE * 0.8f;
+    if (snapshot.punching) {
+        extent = std::max(extent, snapshot.punchRange);
+    }
+    float left = std::min(snapshot.position.x - extent, snapshot.capePosition.x - 7.5f);
+    float top = std::min(snapshot.position.y - extent, snapshot.capePosition.y);
+    float right = std::max(snapshot.position.x + extent, snapshot.capePosition.x + 7.5f);
+    float bottom = std::max(snapshot.position.y + extent, snapshot.capePosition.y + 25.0f);
+    return sf::FloatRect(left, top, right - left, bottom - top);
+}
+
+void Superman::render(const SupermanSnapshot& snapshot, RenderQueue& queue) {
+    const sf::Vector2f& position = snapshot.position;
+    
     // Draw cape first (behind Superman)
-    window.draw(cape);
+    sf::RectangleShape cape(sf::Vector2f(15, 25));
+    cape.setFillColor(sf::Color::Red);
+    cape.setOrigin(7.5f, 0);
+    cape.setPosition(snapshot.capePosition);
+    queue.submit(RenderLayer::Superman, cape);
     
     // Draw Superman body
     sf::RectangleShape body(sf::Vector2f(SIZE * 0.6f, SIZE * 0.8f));
     body.setFillColor(sf::Color::Blue);
     body.setPosition(position.x - SIZE * 0.3f, position.y - SIZE * 0.4f);
-    window.draw(body);
+    queue.submit(RenderLayer::Superman, body);
     
     // Draw Superman logo (chest)
     sf::RectangleShape logo(sf::Vector2f(SIZE * 0.4f, SIZE * 0.3f));
     logo.setFillColor(sf::Color::Red);
     logo.setPosition(position.x - SIZE * 0.2f, position.y - SIZE * 0.25f);
-    window.draw(logo);
-    
-    // Draw S symbol
-    sf::Text sSymbol;
-    sf::Font font; // Note: In real implementation, load font from ResourceManager
-    sSymbol.setFont(font);
-    sSymbol.setString("S");
-    sSymbol.setCharacterSize(static_cast<unsigned int>(SIZE * 0.4f));
-    sSymbol.setFillColor(sf::Color::Yellow);
-    sSymbol.setPosition(position.x - SIZE * 0.1f, position.y - SIZE * 0.2f);
-    // window.draw(sSymbol); // Commented out since font might not load
+    queue.submit(RenderLayer::Superman, logo);
     
     // Draw head
-    sf::CircleShape head(SIZE * 0.25f);
-    head.setFillColor(sf::Color(255, 220, 177)); // Skin color
-    head.setPosition(position.x - SIZE * 0.25f, position.y - SIZE * 0.6f);
-    window.draw(head);
+    queue.submitCircle(RenderLayer::Superman, sf::Vector2f(position.x, position.y - SIZE * 0.35f),
+                       SIZE * 0.25f, sf::Color(255, 220, 177)); // Skin color
     
     // Draw eyes (laser vision effect)
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space)) {
+    if (snapshot.laserEyes) {
         sf::RectangleShape laserEye1(sf::Vector2f(3, 1));
         sf::RectangleShape laserEye2(sf::Vector2f(3, 1));
         laserEye1.setFillColor(sf::Color::Red);
         laserEye2.setFillColor(sf::Color::Red);
         laserEye1.setPosition(position.x - 8, position.y - SIZE * 0.45f);
         laserEye2.setPosition(position.x + 5, position.y - SIZE * 0.45f);
-        window.draw(laserEye1);
-        window.draw(laserEye2);
+        queue.submit(RenderLayer::Superman, laserEye1);
+        queue.submit(RenderLayer::Superman, laserEye2);
     }
     
     // Draw punch effect
-    if (isPunching()) {
-        sf::CircleShape punchEffect(punchRange);
-        punchEffect.setFillColor(sf::Color(255, 255, 0, 64)); // Semi-transparent yellow
-        punchEffect.setPosition(position.x - punchRange, position.y - punchRange);
-        window.draw(punchEffect);
+    if (snapshot.punching) {
+        queue.submitCircle(RenderLayer::Superman, position, snapshot.punchRange,
+                           sf::Color(255, 255, 0, 64)); // Semi-transparent yellow
     }
     
     // Draw health bar above Superman
-    drawHealthBar(window);
+    drawHealthBar(snapshot, queue);
 }
 
 void Superman::handleInput(float deltaTime) {
@@ -144,8 +159,8 @@ void Superman::handleInput(float deltaTime) {
     // Apply acceleration
     velocity += inputDirection * acceleration * deltaTime;
     
-    // Apply friction
-    velocity *= friction;
+    // Apply friction (tuned per frame at 60 FPS, so scaled to the step length)
+    velocity *= std::pow(friction, deltaTime * 60.0f);
     
     // Limit maximum speed
     float currentSpeed = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
@@ -160,8 +175,11 @@ void Superman::move(sf::Vector2f direction, float deltaTime) {
 }
 
 void Superman::performPunch(sf::Vector2f targetPosition) {
-    punchTimer = punchDuration;
+    // A new punch restarts the window
+    punching = true;
     punchTarget = targetPosition;
+    timers.cancel(punchEndTimer);
+    punchEndTimer = timers.schedule(punchDuration, [this] { punching = false; });
 }
 
 sf::FloatRect Superman::getPunchRange() const {
@@ -180,16 +198,20 @@ void Superman::takeDamage(float damage) {
     }
 }
 
-void Superman::regenerateHealth(float deltaTime) {
-    if (regenTimer >= regenRate && health < maxHealth) {
+void Superman::regenerateHealth() {
+    if (health < maxHealth) {
         health += regenAmount;
         if (health > maxHealth) {
             health = maxHealth;
         }
-        regenTimer = 0.0f;
     }
 }
 
+void Superman::scheduleRegeneration() {
+    timers.cancel(regenTimer);
+    regenTimer = timers.schedule(regenRate, [this] { regenerateHealth(); }, regenRate);
+}
+
 sf::FloatRect Superman::getBounds() const {
     return sf::FloatRect(
         position.x - SIZE * 0.5f,
@@ -203,10 +225,11 @@ void Superman::reset(float x, float y) {
     position = sf::Vector2f(x, y);
     velocity = sf::Vector2f(0, 0);
     health = maxHealth;
-    punchTimer = 0;
+    punching = false;
+    timers.cancel(punchEndTimer);
     animationTimer = 0;
     capeAnimationTimer = 0;
-    regenTimer = 0;
+    scheduleRegeneration();
 }
 
 void Superman::updateAnimation(float deltaTime) {
@@ -234,16 +257,14 @@ void Superman::updateCape(float deltaTime) {
     }
 }
 
-void Superman::constrainToWindow(const sf::RenderWindow& window) {
-    sf::Vector2u windowSize = window.getSize();
-    
-    // Keep Superman within window bounds
-    position.x = std::max(SIZE * 0.5f, std::min(static_cast<float>(windowSize.x) - SIZE * 0.5f, position.x));
-    position.y = std::max(SIZE * 0.5f, std::min(static_cast<float>(windowSize.y) - SIZE * 0.5f, position.y));
+void Superman::constrainToBounds(const sf::FloatRect& bounds) {
+    position.x = std::max(bounds.left + SIZE * 0.5f, std::min(bounds.left + bounds.width - SIZE * 0.5f, position.x));
+    position.y = std::max(bounds.top + SIZE * 0.5f, std::min(bounds.top + bounds.height - SIZE * 0.5f, position.y));
 }
 
-void Superman::drawHealthBar(sf::RenderWindow& window) {
-    float healthPercent = health / maxHealth;
+void Superman::drawHealthBar(const SupermanSnapshot& snapshot, RenderQueue& queue) {
+    const sf::Vector2f& position = snapshot.position;
+    float healthPercent = snapshot.health / snapshot.maxHealth;
     
     // Health bar background
     sf::RectangleShape healthBarBg(sf::Vector2f(SIZE, 6));
@@ -257,6 +278,6 @@ void Superman::drawHealthBar(sf::RenderWindow& window) {
     healthBar.setPosition(position.x - SIZE * 0.5f, position.y - SIZE * 0.7f);
     healthBar.setFillColor(sf::Color::Green);
     
-    window.draw(healthBarBg);
-    window.draw(healthBar);
+    queue.submit(RenderLayer::Superman, healthBarBg);
+    queue.submit(RenderLayer::Superman, healthBar);
 }
\ No newline at end of file
@@ -2,14 +2,22 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include "TimingWheel.h"
+
+struct SupermanSnapshot;
+class RenderQueue;
 
 class Superman {
 public:
-    Superman(float x, float y);
+    Superman(float x, float y, TimingWheel& timers);
     ~Superman();
     
-    void update(float deltaTime, const sf::RenderWindow& window);
-    void render(sf::RenderWindow& window);
+    void update(float deltaTime, const sf::FloatRect& worldBounds);
+    
+    // Rendering works from snapshots so it can run on the render thread
+    void writeSnapshot(SupermanSnapshot& snapshot) const;
+    static void render(const SupermanSnapshot& snapshot, RenderQueue& queue);
+    static sf::FloatRect getRenderBounds(const SupermanSnapshot& snapshot);
     
     // Movement and controls
     void handleInput(float deltaTime);
@@ -17,12 +25,11 @@ public:
     
     // Combat
     void performPunch(sf::Vector2f targetPosition);
-    bool isPunching() const { return punchTimer > 0; }
+    bool isPunching() const { return punching; }
     sf::FloatRect getPunchRange() const;
     
     // Health system
     void takeDamage(float damage);
-    void regenerateHealth(float deltaTime);
     float getHealth() const { return health; }
     
     // Position and bounds
@@ -43,10 +50,15 @@ private:
     // Movement
     float speed;
     float acceleration;
-    float friction;
+    float friction; // Velocity kept per frame at 60 FPS
+    
+    // Timers (punch end, health regeneration) fire from the game's timing wheel
+    TimingWheel& timers;
+    TimerHandle punchEndTimer;
+    TimerHandle regenTimer;
     
     // Combat
-    float punchTimer;
+    bool punching;
     float punchDuration;
     float punchRange;
     sf::Vector2f punchTarget;
@@ -63,7 +75,6 @@ private:
     sf::RectangleShape cape;
     
     // Health regeneration
-    float regenTimer;
     float regenRate;
     float regenAmount;
     
@@ -74,7 +85,9 @@ private:
     
     // Helper methods
     void updateAnimation(float deltaTime);
+    void regenerateHealth();
+    void scheduleRegeneration();
     void updateCape(float deltaTime);
-    void constrainToWindow(const sf::RenderWindow& window);
-    void drawHealthBar(sf::RenderWindow& window);
+    void constrainToBounds(const sf::FloatRect& bounds);
+    static void drawHealthBar(const SupermanSnapshot& snapshot, RenderQueue& queue);
 };
\ No newline at end of file
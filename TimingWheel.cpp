@@ -0,0 +1,184 @@
+#include "TimingWheel.h"
+#include <algorithm>
+#include <cmath>
+
+TimingWheel::TimingWheel(float tickSeconds)
+    : buckets(LEVEL0_SLOTS + LEVEL_SLOTS * UPPER_LEVELS, NONE)
+    , freeHead(NONE)
+    , tick(0)
+    , tickSeconds(tickSeconds)
+    , pendingSeconds(0.0f)
+    , pendingCount(0)
+    , firedCount(0) {
+}
+
+TimerHandle TimingWheel::schedule(float delaySeconds, Callback callback, float periodSeconds) {
+    std::uint32_t index = freeHead;
+    if (index != NONE) {
+        freeHead = timers[index].next;
+    } else {
+        index = static_cast<std::uint32_t>(timers.size());
+        timers.push_back(Timer{ Callback(), 0, 0, NONE, NONE, NONE, 0 });
+    }
+
+    Timer& timer = timers[index];
+    timer.callback = std::move(callback);
+    timer.expires = tick + toTicks(delaySeconds);
+    timer.period = periodSeconds > 0.0f ? toTicks(periodSeconds) : 0;
+    insert(index);
+    ++pendingCount;
+    return TimerHandle{ index, timer.generation };
+}
+
+bool TimingWheel::cancel(TimerHandle& handle) {
+    const bool pending = matches(handle);
+    if (pending) {
+        // A timer cancelled from inside its own callback is not in any list
+        if (timers[handle.index].bucket != FIRING) {
+            unlink(handle.index);
+        }
+        release(handle.index);
+    }
+    handle = TimerHandle();
+    return pending;
+}
+
+bool TimingWheel::isPending(const TimerHandle& handle) const {
+    return matches(handle);
+}
+
+float TimingWheel::getSecondsLeft(const TimerHandle& handle) const {
+    if (!matches(handle)) {
+        return 0.0f;
+    }
+    const std::uint64_t expires = timers[handle.index].expires;
+    return expires > tick ? static_cast<float>(expires - tick) * tickSeconds : 0.0f;
+}
+
+void TimingWheel::advance(float seconds) {
+    pendingSeconds += seconds;
+    const std::uint64_t ticks = static_cast<std::uint64_t>(pendingSeconds / tickSeconds);
+    pendingSeconds -= static_cast<float>(ticks) * tickSeconds;
+    advanceTicks(ticks);
+}
+
+void TimingWheel::advanceTicks(std::uint64_t ticks) {
+    for (std::uint64_t i = 0; i < ticks; ++i) {
+        step();
+    }
+}
+
+std::uint64_t TimingWheel::toTicks(float seconds) const {
+    // Never zero, so a timer scheduled from a callback cannot fire in the tick that is running
+    return std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::llround(seconds / tickSeconds)));
+}
+
+void TimingWheel::step() {
+    ++tick;
+    const std::uint32_t slot = static_cast<std::uint32_t>(tick) & (LEVEL0_SLOTS - 1);
+    if (slot == 0) {
+        cascade(1);
+    }
+
+    // Callbacks may schedule or cancel anything, including the rest of this slot,
+    // so take one timer at a time and look everything up again afterwards
+    while (buckets[slot] != NONE) {
+        const std::uint32_t index = buckets[slot];
+        unlink(index);
+        Timer& timer = timers[index];
+        Callback callback = std::move(timer.callback);
+        const std::uint32_t generation = timer.generation;
+        const std::uint64_t period = timer.period;
+        ++firedCount;
+
+        if (period == 0) {
+            release(index);
+            callback();
+            continue;
+        }
+
+        timer.bucket = FIRING;
+        callback();
+        Timer& repeat = timers[index];
+        if (repeat.generation == generation && repeat.bucket == FIRING) {
+            repeat.callback = std::move(callback);
+            repeat.expires = tick + period;
+            insert(index);
+        }
+    }
+}
+
+void TimingWheel::cascade(int level) {
+    const int shift = LEVEL0_BITS + LEVEL_BITS * (level - 1);
+    const std::uint32_t slot = static_cast<std::uint32_t>(tick >> shift) & (LEVEL_SLOTS - 1);
+
+    // The level above wraps together with this one; whatever it moves down may land in this slot
+    if (slot == 0 && level < UPPER_LEVELS) {
+        cascade(level + 1);
+    }
+
+    const std::uint32_t bucket = LEVEL0_SLOTS + LEVEL_SLOTS * (level - 1) + slot;
+    std::uint32_t index = buckets[bucket];
+    buckets[bucket] = NONE;
+    while (index != NONE) {
+        const std::uint32_t next = timers[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+void TimingWheel::insert(std::uint32_t index) {
+    Timer& timer = timers[index];
+    // Past the top level's reach, park at its far end and re-file when it comes round
+    const std::uint64_t delay = std::min(timer.expires > tick ? timer.expires - tick : 0, MAX_DELAY);
+    const std::uint64_t expires = tick + delay;
+
+    std::uint32_t bucket;
+    if (delay < LEVEL0_SLOTS) {
+        bucket = static_cast<std::uint32_t>(expires) & (LEVEL0_SLOTS - 1);
+    } else {
+        int level = 1;
+        int shift = LEVEL0_BITS;
+        while (level < UPPER_LEVELS && delay >= (1ull << (shift + LEVEL_BITS))) {
+            ++level;
+            shift += LEVEL_BITS;
+        }
+        bucket = LEVEL0_SLOTS + LEVEL_SLOTS * (level - 1) + (static_cast<std::uint32_t>(expires >> shift) & (LEVEL_SLOTS - 1));
+    }
+
+    timer.bucket = bucket;
+    timer.prev = NONE;
+    timer.next = buckets[bucket];
+    if (timer.next != NONE) {
+        timers[timer.next].prev = index;
+    }
+    buckets[bucket] = index;
+}
+
+void TimingWheel::unlink(std::uint32_t index) {
+    Timer& timer = timers[index];
+    if (timer.prev != NONE) {
+        timers[timer.prev].next = timer.next;
+    } else {
+        buckets[timer.bucket] = timer.next;
+    }
+    if (timer.next != NONE) {
+        timers[timer.next].prev = timer.prev;
+    }
+}
+
+void TimingWheel::release(std::uint32_t index) {
+    Timer& timer = timers[index];
+    timer.callback = nullptr;
+    timer.bucket = NONE;
+    ++timer.generation;
+    timer.prev = NONE;
+    timer.next = freeHead;
+    freeHead = index;
+    --pendingCount;
+}
+
+bool TimingWheel::matches(const TimerHandle& handle) const {
+    return handle.index < timers.size() && timers[handle.index].generation == handle.generation
+        && timers[handle.index].bucket != NONE;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Refers to a scheduled timer. Stays safe to cancel after the timer has fired
+// or been cancelled: a stale handle simply matches nothing.
+struct TimerHandle {
+    std::uint32_t index = 0xFFFFFFFF;
+    std::uint32_t generation = 0;
+};
+
+// Hierarchical timing wheel at a fixed tick length (the simulation tick).
+//
+// Level 0 has 256 one-tick slots; each level above has 64 slots, each as wide
+// as a whole turn of the level below (256, 16384 and 1048576 ticks). A timer
+// goes into the coarsest level its delay needs and moves down a level each
+// time the level below wraps, until it sits in a one-tick slot and fires.
+// At 120 ticks per second the top level reaches about six days; longer delays
+// are parked at the far end and re-filed on the way down.
+//
+// Schedule and cancel are O(1). A tick only touches the timers in its own slot,
+// plus, every 256 ticks, those moving down from the slot above.
+class TimingWheel {
+public:
+    using Callback = std::function<void()>;
+
+    explicit TimingWheel(float tickSeconds);
+
+    // Fires after delaySeconds (at least one tick), then every periodSeconds if that is above zero.
+    // The handle of a repeating timer stays valid until it is cancelled.
+    TimerHandle schedule(float delaySeconds, Callback callback, float periodSeconds = 0.0f);
+    // Returns false if the timer had already fired (one-shot) or been cancelled
+    bool cancel(TimerHandle& handle);
+    bool isPending(const TimerHandle& handle) const;
+    // Zero for a timer that is not pending
+    float getSecondsLeft(const TimerHandle& handle) const;
+
+    // Runs every tick that fits in the elapsed time; the remainder carries over
+    void advance(float seconds);
+    void advanceTicks(std::uint64_t ticks);
+
+    std::uint64_t getTick() const { return tick; }
+    float getTickSeconds() const { return tickSeconds; }
+    std::size_t getPendingCount() const { return pendingCount; }
+    std::uint64_t getFiredCount() const { return firedCount; }
+
+private:
+    static constexpr std::uint32_t NONE = 0xFFFFFFFF;
+    static constexpr std::uint32_t FIRING = 0xFFFFFFFE; // Bucket of a timer whose callback is running
+    static constexpr int LEVEL0_BITS = 8;
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr int UPPER_LEVELS = 3;
+    static constexpr std::uint32_t LEVEL0_SLOTS = 1u << LEVEL0_BITS;
+    static constexpr std::uint32_t LEVEL_SLOTS = 1u << LEVEL_BITS;
+    static constexpr std::uint64_t MAX_DELAY = (1ull << (LEVEL0_BITS + LEVEL_BITS * UPPER_LEVELS)) - 1;
+
+    struct Timer {
+        Callback callback;
+        std::uint64_t expires;
+        std::uint64_t period; // Ticks; 0 for one-shot
+        std::uint32_t prev;
+        std::uint32_t next;
+        std::uint32_t bucket; // NONE when free
+        std::uint32_t generation;
+    };
+
+    std::vector<Timer> timers;
+    std::vector<std::uint32_t> buckets; // List heads: level 0 slots, then each upper level's
+    std::uint32_t freeHead;
+    std::uint64_t tick; // Last tick run
+    float tickSeconds;
+    float pendingSeconds;
+    std::size_t pendingCount;
+    std::uint64_t firedCount;
+
+    std::uint64_t toTicks(float seconds) const;
+    void step();
+    void cascade(int level);
+    void insert(std::uint32_t index);
+    void unlink(std::uint32_t index);
+    void release(std::uint32_t index);
+    bool matches(const TimerHandle& handle) const;
+};
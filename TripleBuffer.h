@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Lock-free triple buffer for handing the latest value from one producer
+// thread to one consumer thread. The producer fills the write buffer and
+// publishes it; the consumer picks up the most recently published buffer.
+// Neither side ever waits, and buffers are reused so their allocations are
+// kept from one frame to the next.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer()
+        : writeIndex(0)
+        , readIndex(1)
+        , ready(2) {
+    }
+
+    // Producer side
+    T& getWriteBuffer() { return buffers[writeIndex]; }
+    void publish() {
+        const unsigned int previous = ready.exchange(writeIndex | FRESH, std::memory_order_acq_rel);
+        writeIndex = previous & INDEX_MASK;
+    }
+
+    // Consumer side; returns false (and keeps the current buffer) when nothing new was published
+    bool acquire() {
+        if (!(ready.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        const unsigned int previous = ready.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        return true;
+    }
+    const T& getReadBuffer() const { return buffers[readIndex]; }
+
+private:
+    static const unsigned int INDEX_MASK = 3;
+    static const unsigned int FRESH = 4;
+
+    std::array<T, 3> buffers;
+    unsigned int writeIndex;
+    unsigned int readIndex;
+    // Index of the spare buffer, flagged FRESH when it holds an unread publish
+    std::atomic<unsigned int> ready;
+};
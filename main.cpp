@@ -1,7 +1,7 @@
 #include <SFML/Graphics.hpp>
-#include <iostream>
 #include <memory>
 #include "Game.h"
+#include "Logger.h"
 
 int main() {
     try {
@@ -10,7 +10,8 @@ int main() {
         
         // Initialize the game
         if (!game->initialize()) {
-            std::cerr << "Failed to initialize game!" << std::endl;
+            LOG_ERROR("Game", "Failed to initialize game!");
+            Logger::instance().shutdown();
             return -1;
         }
         
@@ -18,9 +19,12 @@ int main() {
         game->run();
         
     } catch (const std::exception& e) {
-        std::cerr << "Game error: " << e.what() << std::endl;
+        LOG_ERROR("Game", "Game error: %s", e.what());
+        Logger::instance().shutdown();
         return -1;
     }
     
+    // Write out anything still queued
+    Logger::instance().shutdown();
     return 0;
 }
\ No newline at end of file
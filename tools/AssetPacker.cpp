@@ -0,0 +1,61 @@
+#include "../AssetPack.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Asset packer tool
+// Usage: asset_packer <assets directory> <output .pak file>
+//
+// Packs every file under textures/, sounds/, fonts/ and data/ into a single
+// archive that ResourceManager can memory-map at startup.
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <assets directory> <output .pak file>" << std::endl;
+        return 1;
+    }
+
+    const std::filesystem::path assetsDir(argv[1]);
+    const std::filesystem::path outputFile(argv[2]);
+    const char* subdirectories[] = { "textures", "sounds", "fonts", "data" };
+
+    std::vector<std::filesystem::path> files;
+    try {
+        for (const char* subdirectory : subdirectories) {
+            std::filesystem::path dir = assetsDir / subdirectory;
+            if (!std::filesystem::is_directory(dir)) {
+                continue;
+            }
+            for (const auto& item : std::filesystem::recursive_directory_iterator(dir)) {
+                if (item.is_regular_file()) {
+                    files.push_back(item.path());
+                }
+            }
+        }
+    } catch (const std::filesystem::filesystem_error& e) {
+        std::cerr << "Failed to scan assets: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Sort so the same inputs always produce the same pack
+    std::sort(files.begin(), files.end());
+
+    AssetPackWriter writer;
+    for (const auto& file : files) {
+        std::string name = file.lexically_relative(assetsDir).generic_string();
+        if (!writer.addFile(name, file.string())) {
+            std::cerr << "Failed to read " << file.string() << std::endl;
+            return 1;
+        }
+        std::cout << "  + " << name << std::endl;
+    }
+
+    if (!writer.write(outputFile.string())) {
+        std::cerr << "Failed to write " << outputFile.string() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << writer.getEntryCount() << " assets into " << outputFile.string() << std::endl;
+    return 0;
+}
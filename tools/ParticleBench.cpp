@@ -0,0 +1,162 @@
+#include "../CompactParticle.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Particle update benchmark
+// Usage: particle_bench [steps]
+//
+// Compares the particle layout ParticleSystem used before the compact format
+// (heap-allocated and by value) with CompactParticle, at the game's budget
+// and at a size well beyond the caches. Each step runs the explosion physics
+// the game uses: gravity, air resistance, fade and growth.
+
+namespace {
+    // Field for field the old ParticleSystem particle, with sf types spelled out
+    struct LegacyParticle {
+        float positionX, positionY;
+        float velocityX, velocityY;
+        std::uint8_t r, g, b, a;
+        float life;
+        float maxLife;
+        float size;
+        float rotation;
+        float rotationSpeed;
+        int type;
+    };
+
+    const float DELTA_TIME = 1.0f / 120.0f;
+    const float GRAVITY = 150.0f;
+    const float DRAG = 0.98f;
+
+    LegacyParticle makeLegacy(std::mt19937& rng) {
+        std::uniform_real_distribution<float> speed(-200.0f, 200.0f);
+        LegacyParticle particle = {};
+        particle.velocityX = speed(rng);
+        particle.velocityY = speed(rng);
+        particle.r = 255;
+        particle.g = 165;
+        particle.a = 255;
+        particle.life = 7.5f;
+        particle.maxLife = 7.5f;
+        particle.size = 4.0f;
+        particle.rotationSpeed = 90.0f;
+        return particle;
+    }
+
+    CompactParticle makeCompact(std::mt19937& rng) {
+        std::uniform_real_distribution<float> speed(-200.0f, 200.0f);
+        CompactParticle particle = {};
+        particle.velocityX = speed(rng);
+        particle.velocityY = speed(rng);
+        particle.lifetime = static_cast<std::uint8_t>(7.5f * CompactParticle::LIFETIME_SCALE);
+        particle.color = CompactParticle::toPaletteIndex(255, 165, 0);
+        particle.size = 4 * CompactParticle::SIZE_SCALE;
+        particle.spin = 30;
+        return particle;
+    }
+
+    // The old ParticleSystem::updateParticle for an explosion particle
+    void updateLegacy(LegacyParticle& particle) {
+        particle.life -= DELTA_TIME;
+        if (particle.life <= 0) {
+            return;
+        }
+        particle.positionX += particle.velocityX * DELTA_TIME;
+        particle.positionY += particle.velocityY * DELTA_TIME;
+        particle.rotation += particle.rotationSpeed * DELTA_TIME;
+        particle.velocityY += GRAVITY * DELTA_TIME;
+        particle.velocityX *= DRAG;
+        particle.velocityY *= DRAG;
+        particle.a = static_cast<std::uint8_t>(255 * (particle.life / particle.maxLife));
+        particle.size *= 1.01f;
+    }
+
+    template <typename Setup, typename Step>
+    double measure(int steps, std::size_t count, Setup setup, Step step) {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; ++i) {
+            step();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+        return nanoseconds / (static_cast<double>(steps) * count);
+    }
+
+    void run(std::size_t count, int steps) {
+        std::mt19937 rng(1234);
+        double checksum = 0.0;
+
+        std::vector<std::unique_ptr<LegacyParticle>> heap;
+        const double heapTime = measure(steps, count, [&] {
+            heap.clear();
+            for (std::size_t i = 0; i < count; ++i) {
+                heap.push_back(std::make_unique<LegacyParticle>(makeLegacy(rng)));
+            }
+            // Shuffle so allocation order does not hide the indirection, as after many spawns and deaths
+            std::shuffle(heap.begin(), heap.end(), rng);
+        }, [&] {
+            for (auto& particle : heap) {
+                updateLegacy(*particle);
+            }
+        });
+        for (const auto& particle : heap) {
+            checksum += particle->positionX;
+        }
+
+        std::vector<LegacyParticle> legacy;
+        const double legacyTime = measure(steps, count, [&] {
+            legacy.clear();
+            for (std::size_t i = 0; i < count; ++i) {
+                legacy.push_back(makeLegacy(rng));
+            }
+        }, [&] {
+            for (auto& particle : legacy) {
+                updateLegacy(particle);
+            }
+        });
+        for (const auto& particle : legacy) {
+            checksum += particle.positionX;
+        }
+
+        CompactParticleArray compact;
+        const double compactTime = measure(steps, count, [&] {
+            compact.clear();
+            for (std::size_t i = 0; i < count; ++i) {
+                compact.add(makeCompact(rng));
+            }
+        }, [&] {
+            advanceParticles(compact, GRAVITY, DRAG, DELTA_TIME);
+        });
+        for (std::int16_t offset : compact.offsetX) {
+            checksum += offset;
+        }
+
+        std::printf("%8zu particles  %6.2f ns heap  %6.2f ns by value  %6.2f ns compact  (%zu / %zu / %zu KiB)  [%g]\n",
+                    count, heapTime, legacyTime, compactTime,
+                    count * (sizeof(LegacyParticle) + sizeof(void*)) / 1024, count * sizeof(LegacyParticle) / 1024,
+                    count * sizeof(CompactParticle) / 1024, checksum);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // Short of the 7.5 s lifetime at 120 steps per second, so every particle stays alive
+    const int steps = argc > 1 ? std::atoi(argv[1]) : 600;
+    if (steps <= 0 || steps > 880) {
+        std::fprintf(stderr, "Usage: %s [steps, 1-880]\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("Particle size: %zu bytes before, %zu bytes compact; update cost per particle per step:\n",
+                sizeof(LegacyParticle), sizeof(CompactParticle));
+    const std::size_t counts[] = { 1000, 16384, 262144, 1048576 };
+    for (std::size_t count : counts) {
+        run(count, steps);
+    }
+    return 0;
+}